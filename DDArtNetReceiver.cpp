@@ -0,0 +1,228 @@
+/*
+ * DDArtNetReceiver.cpp - Art-Net pixel stream receiver for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_NSAPI_PRESENT
+
+#include "DDArtNetReceiver.h"
+
+#define ARTNET_OP_DMX        0x5000
+#define ARTNET_OP_SYNC       0x5200
+#define ARTNET_OP_TIMECODE   0x9700
+
+#define ARTNET_HEADER_SIZE   18
+#define ARTNET_TIMECODE_SIZE 19
+#define ARTNET_LEDS_PER_UNIVERSE 170
+
+static const uint8_t ARTNET_ID[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+
+DDArtNetReceiver::DDArtNetReceiver()
+    : _mappingCount(0)
+    , _syncMode(false)
+    , _syncAt(0)
+{
+    resetStatistics();
+    _timer.start();
+}
+
+bool DDArtNetReceiver::addMapping(uint16_t universe, DDFrameBuffer &frame, uint16_t firstLed, uint16_t ledCount)
+{
+    if (_mappingCount >= MAX_MAPPINGS) {
+        return false;
+    }
+    if (ledCount > ARTNET_LEDS_PER_UNIVERSE) {
+        ledCount = ARTNET_LEDS_PER_UNIVERSE;
+    }
+    Mapping &m = _mappings[_mappingCount++];
+    m.universe = universe & 0x7FFF;
+    m.frame = &frame;
+    m.firstLed = firstLed;
+    m.ledCount = ledCount;
+    m.dirty = false;
+    return true;
+}
+
+void DDArtNetReceiver::attachTimecode(Callback<void(uint32_t)> timecode)
+{
+    _timecode = timecode;
+}
+
+nsapi_error_t DDArtNetReceiver::open(NetworkInterface *network, uint16_t port)
+{
+    nsapi_error_t result = _socket.open(network);
+    if (result != NSAPI_ERROR_OK) {
+        return result;
+    }
+    result = _socket.bind(port);
+    if (result != NSAPI_ERROR_OK) {
+        _socket.close();
+        return result;
+    }
+    _socket.set_blocking(false);
+    return NSAPI_ERROR_OK;
+}
+
+uint16_t DDArtNetReceiver::poll()
+{
+    uint16_t count = 0;
+    while (true) {
+        nsapi_size_or_error_t length = _socket.recvfrom(NULL, _buffer, sizeof (_buffer));
+        if (length <= 0) {
+            break;
+        }
+        // packets are decoded in place from the receive buffer
+        handlePacket(_buffer, length);
+        count++;
+    }
+    return count;
+}
+
+bool DDArtNetReceiver::handlePacket(const uint8_t *data, uint16_t length)
+{
+    if (length < 10 || memcmp(data, ARTNET_ID, sizeof (ARTNET_ID)) != 0) {
+        return false;
+    }
+
+    uint16_t opCode = data[8] | (data[9] << 8);
+    if (opCode == ARTNET_OP_DMX && length >= ARTNET_HEADER_SIZE) {
+        handleDmx(data, length);
+        return true;
+    }
+    if (opCode == ARTNET_OP_SYNC) {
+        handleSync();
+        return true;
+    }
+    if (opCode == ARTNET_OP_TIMECODE && length >= ARTNET_TIMECODE_SIZE) {
+        handleTimecode(data);
+        return true;
+    }
+    return false;
+}
+
+void DDArtNetReceiver::handleDmx(const uint8_t *data, uint16_t length)
+{
+    uint32_t start = _timer.read_us();
+
+    if (_syncMode && start - _syncAt > SYNC_TIMEOUT) {
+        // the sender stopped sending ArtSync, the frames are not completed by it anymore
+        _syncMode = false;
+    }
+
+    uint16_t universe = (data[14] | (data[15] << 8)) & 0x7FFF;
+    uint16_t channels = (data[16] << 8) | data[17];
+    if (channels > length - ARTNET_HEADER_SIZE) {
+        channels = length - ARTNET_HEADER_SIZE;
+    }
+    const uint8_t *dmx = data + ARTNET_HEADER_SIZE;
+
+    for (uint8_t i = 0; i < _mappingCount; i++) {
+        Mapping &m = _mappings[i];
+        if (m.universe != universe) {
+            continue;
+        }
+
+        uint16_t size = m.frame->getSize();
+        uint16_t count = channels / 3;
+        if (count > m.ledCount) {
+            count = m.ledCount;
+        }
+        if (m.firstLed >= size) {
+            continue;
+        }
+        if (m.firstLed + count > size) {
+            count = size - m.firstLed;
+        }
+        memcpy(m.frame->getData() + m.firstLed * 3, dmx, count * 3);
+        m.dirty = true;
+
+        // without sync the universe holding the last LED completes the frame
+        if (!_syncMode && m.firstLed + m.ledCount >= size) {
+            m.frame->flush();
+            for (uint8_t j = 0; j < _mappingCount; j++) {
+                if (_mappings[j].frame == m.frame) {
+                    _mappings[j].dirty = false;
+                }
+            }
+        }
+    }
+
+    uint32_t latency = _timer.read_us() - start;
+    _packets++;
+    _latencySum += latency;
+    if (latency < _latencyMin) {
+        _latencyMin = latency;
+    }
+    if (latency > _latencyMax) {
+        _latencyMax = latency;
+    }
+}
+
+void DDArtNetReceiver::handleSync()
+{
+    _syncMode = true;
+    _syncAt = _timer.read_us();
+    for (uint8_t i = 0; i < _mappingCount; i++) {
+        if (!_mappings[i].dirty) {
+            continue;
+        }
+        DDFrameBuffer *frame = _mappings[i].frame;
+        frame->flush();
+        // mark all mappings of this frame buffer as sent
+        for (uint8_t j = i; j < _mappingCount; j++) {
+            if (_mappings[j].frame == frame) {
+                _mappings[j].dirty = false;
+            }
+        }
+    }
+}
+
+void DDArtNetReceiver::handleTimecode(const uint8_t *data)
+{
+    if (!_timecode) {
+        return;
+    }
+
+    // frame rates of the types film, EBU, DF and SMPTE; drop frame is treated as 30 fps
+    static const uint8_t FRAME_RATES[4] = {24, 25, 30, 30};
+    uint8_t frames = data[14];
+    uint8_t seconds = data[15];
+    uint8_t minutes = data[16];
+    uint8_t hours = data[17];
+    uint8_t rate = FRAME_RATES[data[18] & 0x03];
+
+    uint32_t showTime = ((hours * 60 + minutes) * 60 + seconds) * 1000 + frames * 1000 / rate;
+    _timecode(showTime);
+}
+
+uint32_t DDArtNetReceiver::getPacketCount() const
+{
+    return _packets;
+}
+
+uint32_t DDArtNetReceiver::getLatencyMin() const
+{
+    return _packets ? _latencyMin : 0;
+}
+
+uint32_t DDArtNetReceiver::getLatencyMax() const
+{
+    return _latencyMax;
+}
+
+uint32_t DDArtNetReceiver::getLatencyAverage() const
+{
+    return _packets ? _latencySum / _packets : 0;
+}
+
+void DDArtNetReceiver::resetStatistics()
+{
+    _packets = 0;
+    _latencyMin = 0xFFFFFFFF;
+    _latencyMax = 0;
+    _latencySum = 0;
+}
+
+#endif // MBED_CONF_NSAPI_PRESENT
@@ -0,0 +1,145 @@
+/*
+ * DDArtNetReceiver.h - Art-Net pixel stream receiver for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDARTNETRECEIVER_H
+#define DD_BOOSTER_DDARTNETRECEIVER_H
+
+#include "DDFrameBuffer.h"
+#include "UDPSocket.h"
+#include "NetworkInterface.h"
+
+/**
+ * @brief Receives Art-Net DMX packets and maps their channels to LEDs.
+ *
+ * Each mapping assigns a universe to a range of LEDs of a frame buffer, DMX channels are
+ * read as RGB triplets (170 LEDs per universe). The pixel data is copied from the receive
+ * buffer directly into the frame buffer, no intermediate frame is kept.
+ *
+ * Without ArtSync a frame buffer is flushed as soon as the universe containing its last
+ * LED was received. Once an ArtSync packet was seen, frame buffers are flushed on ArtSync only.
+ * If no ArtSync arrives for SYNC_TIMEOUT, e.g. because the sender was switched, the receiver
+ * returns to flushing on the last universe as the Art-Net specification requires.
+ *
+ * ArtTimeCode packets are converted to milliseconds and passed to the callback registered
+ * with attachTimecode().
+ *
+ * For every DMX packet the time from reception to the end of processing (including the
+ * flush if one was triggered) is measured.
+ *
+ * handlePacket() can be called with packets from any source, which allows feeding
+ * recorded or generated packets without a network.
+ */
+class DDArtNetReceiver {
+public:
+
+    /**
+     * Default Art-Net UDP port.
+     */
+    static const uint16_t ARTNET_PORT = 6454;
+
+    /**
+     * Maximal number of universe mappings.
+     */
+    static const uint8_t MAX_MAPPINGS = 8;
+
+    /**
+     * Time in microseconds without ArtSync after which DMX packets are output immediately.
+     */
+    static const uint32_t SYNC_TIMEOUT = 4000000;
+
+    DDArtNetReceiver();
+
+    /**
+     * Maps a universe to a range of LEDs. DMX channel 1 - 3 is the color of the first LED.
+     * @param universe - 15 bit Art-Net port address (net, sub-net, universe)
+     * @param frame - Frame buffer to write to
+     * @param firstLed - Index of the LED receiving the first channel triplet
+     * @param ledCount - Number of LEDs mapped, max. 170
+     * @return false if all mapping slots are used
+     */
+    bool addMapping(uint16_t universe, DDFrameBuffer &frame, uint16_t firstLed, uint16_t ledCount);
+
+    /**
+     * Registers a callback receiving the show time of ArtTimeCode packets.
+     * @param timecode - Called with the show time in milliseconds
+     */
+    void attachTimecode(Callback<void(uint32_t)> timecode);
+
+    /**
+     * Opens the UDP socket in non-blocking mode.
+     * @param network - Connected network interface
+     * @param port - UDP port, ARTNET_PORT is default
+     * @return NSAPI_ERROR_OK on success
+     */
+    nsapi_error_t open(NetworkInterface *network, uint16_t port = ARTNET_PORT);
+
+    /**
+     * Processes all packets waiting in the socket. Call it from the main loop.
+     * @return number of processed packets
+     */
+    uint16_t poll();
+
+    /**
+     * Processes one Art-Net packet.
+     * @param data - Packet content starting with the Art-Net ID
+     * @param length - Packet length in bytes
+     * @return true if the packet was a valid ArtDmx, ArtSync or ArtTimeCode packet
+     */
+    bool handlePacket(const uint8_t *data, uint16_t length);
+
+    /**
+     * Returns the number of processed DMX packets.
+     */
+    uint32_t getPacketCount() const;
+
+    /**
+     * Returns the minimal processing time of a DMX packet in microseconds.
+     */
+    uint32_t getLatencyMin() const;
+
+    /**
+     * Returns the maximal processing time of a DMX packet in microseconds.
+     */
+    uint32_t getLatencyMax() const;
+
+    /**
+     * Returns the average processing time of a DMX packet in microseconds.
+     */
+    uint32_t getLatencyAverage() const;
+
+    /**
+     * Resets the packet counter and the latency statistics.
+     */
+    void resetStatistics();
+
+private:
+    struct Mapping {
+        uint16_t universe;
+        DDFrameBuffer *frame;
+        uint16_t firstLed;
+        uint16_t ledCount;
+        bool dirty;
+    };
+
+    void handleDmx(const uint8_t *data, uint16_t length);
+    void handleSync();
+    void handleTimecode(const uint8_t *data);
+
+    UDPSocket _socket;
+    Mapping _mappings[MAX_MAPPINGS];
+    uint8_t _mappingCount;
+    bool _syncMode;
+    uint32_t _syncAt;
+    Callback<void(uint32_t)> _timecode;
+    Timer _timer;
+    uint32_t _packets;
+    uint32_t _latencyMin;
+    uint32_t _latencyMax;
+    uint64_t _latencySum;
+    uint8_t _buffer[530];
+};
+
+#endif //DD_BOOSTER_DDARTNETRECEIVER_H
@@ -0,0 +1,255 @@
+/*
+ * DDAudio.cpp - Audio reactive LED output for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDAudio.h"
+
+// first half of a sine period over 128 steps in Q15
+static const int16_t SINE[64] = {
+    0, 1608, 3212, 4808, 6393, 7962, 9512, 11039,
+    12539, 14010, 15446, 16846, 18204, 19519, 20787, 22005,
+    23170, 24279, 25329, 26319, 27245, 28105, 28898, 29621,
+    30273, 30852, 31356, 31785, 32137, 32412, 32609, 32728,
+    32767, 32728, 32609, 32412, 32137, 31785, 31356, 30852,
+    30273, 29621, 28898, 28105, 27245, 26319, 25329, 24279,
+    23170, 22005, 20787, 19519, 18204, 16846, 15446, 14010,
+    12539, 11039, 9512, 7962, 6393, 4808, 3212, 1608
+};
+
+// first half of a Hann window over 128 samples in Q15, the second half is mirrored
+static const int16_t HANN[64] = {
+    0, 20, 80, 180, 320, 499, 717, 973,
+    1267, 1597, 1965, 2367, 2803, 3273, 3775, 4308,
+    4870, 5461, 6078, 6721, 7387, 8075, 8784, 9511,
+    10254, 11013, 11785, 12569, 13361, 14161, 14967, 15776,
+    16586, 17396, 18203, 19006, 19803, 20591, 21369, 22135,
+    22886, 23622, 24340, 25039, 25716, 26371, 27001, 27605,
+    28181, 28729, 29247, 29733, 30186, 30606, 30990, 31340,
+    31652, 31927, 32164, 32363, 32522, 32642, 32722, 32762
+};
+
+// first FFT bin of each band, the last entry ends the last band
+static const uint8_t BAND_EDGES[DDAudioAnalyzer::NUM_BANDS + 1] = {1, 2, 3, 5, 8, 13, 21, 34, 64};
+
+// minimal peak, keeps silence from being amplified to full brightness
+#define AUDIO_PEAK_FLOOR     256
+
+// blocks after a beat during which no new beat is detected
+#define AUDIO_BEAT_HOLD      4
+
+static inline int32_t sine(uint8_t k)
+{
+    return k < 64 ? SINE[k] : -SINE[k - 64];
+}
+
+static void hueToRGB(uint16_t h, uint8_t v, uint8_t *rgb)
+{
+    // hue 0 - 359 in six sectors with full saturation
+    uint8_t sector = h / 60;
+    uint16_t rise = (h % 60) * v / 60;
+    uint16_t fall = v - rise;
+    switch (sector) {
+    case 0: rgb[0] = v; rgb[1] = rise; rgb[2] = 0; break;
+    case 1: rgb[0] = fall; rgb[1] = v; rgb[2] = 0; break;
+    case 2: rgb[0] = 0; rgb[1] = v; rgb[2] = rise; break;
+    case 3: rgb[0] = 0; rgb[1] = fall; rgb[2] = v; break;
+    case 4: rgb[0] = rise; rgb[1] = 0; rgb[2] = v; break;
+    default: rgb[0] = v; rgb[1] = 0; rgb[2] = fall; break;
+    }
+}
+
+DDAudioAnalyzer::DDAudioAnalyzer()
+    : _bassAverage(0)
+    , _sinceBeat(0)
+    , _bassHigh(false)
+    , _beat(false)
+{
+    memset(_level, 0, sizeof (_level));
+    for (uint8_t b = 0; b < NUM_BANDS; b++) {
+        _peak[b] = AUDIO_PEAK_FLOOR;
+    }
+}
+
+void DDAudioAnalyzer::analyze(const int16_t *samples)
+{
+    for (uint16_t i = 0; i < BLOCK_SIZE; i++) {
+        int32_t w = HANN[i < 64 ? i : BLOCK_SIZE - 1 - i];
+        _re[i] = samples[i] * w >> 15;
+        _im[i] = 0;
+    }
+
+    fft();
+
+    uint32_t bass = 0;
+    for (uint8_t b = 0; b < NUM_BANDS; b++) {
+        // |re| + |im| approximates the magnitude without a square root
+        uint32_t energy = 0;
+        for (uint8_t k = BAND_EDGES[b]; k < BAND_EDGES[b + 1]; k++) {
+            energy += (_re[k] < 0 ? -_re[k] : _re[k]) + (_im[k] < 0 ? -_im[k] : _im[k]);
+        }
+
+        _peak[b] -= _peak[b] >> 6;
+        if (_peak[b] < energy) {
+            _peak[b] = energy;
+        }
+        if (_peak[b] < AUDIO_PEAK_FLOOR) {
+            _peak[b] = AUDIO_PEAK_FLOOR;
+        }
+        _level[b] = energy * 255 / _peak[b];
+
+        if (b < 2) {
+            bass += energy;
+        }
+    }
+
+    // beat: bass energy rising 1.5 times above its running average. A decaying kick stays
+    // above it for several blocks, it has to fall below before the next beat
+    bool high = bass * 2 > _bassAverage * 3 && bass > AUDIO_PEAK_FLOOR;
+    _beat = high && !_bassHigh && _sinceBeat >= AUDIO_BEAT_HOLD;
+    _bassHigh = high;
+    _sinceBeat = _beat ? 0 : (_sinceBeat < 255 ? _sinceBeat + 1 : 255);
+    _bassAverage += ((int32_t) bass - (int32_t) _bassAverage) / 32;
+}
+
+void DDAudioAnalyzer::fft()
+{
+    // bit reversed order
+    for (uint16_t i = 1, j = 0; i < BLOCK_SIZE; i++) {
+        uint16_t bit = BLOCK_SIZE >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int16_t t = _re[i];
+            _re[i] = _re[j];
+            _re[j] = t;
+        }
+    }
+
+    // each stage is scaled by 1/2 to stay in the 16 bit range
+    for (uint16_t size = 2; size <= BLOCK_SIZE; size <<= 1) {
+        uint16_t half = size >> 1;
+        uint16_t step = BLOCK_SIZE / size;
+        for (uint16_t i = 0; i < BLOCK_SIZE; i += size) {
+            for (uint16_t j = 0; j < half; j++) {
+                uint8_t k = j * step;
+                int32_t wr = sine((k + BLOCK_SIZE / 4) % BLOCK_SIZE);
+                int32_t wi = -sine(k);
+                uint16_t a = i + j;
+                uint16_t b = a + half;
+                int32_t tr = (wr * _re[b] - wi * _im[b]) >> 15;
+                int32_t ti = (wr * _im[b] + wi * _re[b]) >> 15;
+                _re[b] = (_re[a] - tr) >> 1;
+                _im[b] = (_im[a] - ti) >> 1;
+                _re[a] = (_re[a] + tr) >> 1;
+                _im[a] = (_im[a] + ti) >> 1;
+            }
+        }
+    }
+}
+
+uint8_t DDAudioAnalyzer::getLevel(uint8_t band) const
+{
+    return band < NUM_BANDS ? _level[band] : 0;
+}
+
+bool DDAudioAnalyzer::isBeat() const
+{
+    return _beat;
+}
+
+DDAudioVisualizer::DDAudioVisualizer(DDFrameBuffer &frame)
+    : _frame(frame)
+    , _bound(0)
+    , _pending(false)
+    , _pushedAt(0)
+    , _latency(0)
+    , _latencyMax(0)
+    , _dropped(0)
+{
+}
+
+void DDAudioVisualizer::setLatencyBound(uint32_t bound)
+{
+    _bound = bound;
+}
+
+void DDAudioVisualizer::push(const int16_t *samples)
+{
+    core_util_critical_section_enter();
+    if (_pending) {
+        // the previous block was not processed in time and is replaced
+        _dropped++;
+    }
+    memcpy(_block, samples, sizeof (_block));
+    _pushedAt = us_ticker_read();
+    _pending = true;
+    core_util_critical_section_exit();
+}
+
+bool DDAudioVisualizer::poll()
+{
+    core_util_critical_section_enter();
+    bool pending = _pending;
+    uint32_t pushedAt = _pushedAt;
+    if (pending) {
+        memcpy(_work, _block, sizeof (_work));
+        _pending = false;
+    }
+    core_util_critical_section_exit();
+
+    if (!pending) {
+        return false;
+    }
+    if (_bound && us_ticker_read() - pushedAt > _bound) {
+        // too old, showing it would exceed the latency bound
+        _dropped++;
+        return false;
+    }
+
+    _analyzer.analyze(_work);
+    render(_analyzer);
+    _frame.flush();
+
+    _latency = us_ticker_read() - pushedAt;
+    if (_latency > _latencyMax) {
+        _latencyMax = _latency;
+    }
+    return true;
+}
+
+void DDAudioVisualizer::render(const DDAudioAnalyzer &analyzer)
+{
+    uint16_t size = _frame.getSize();
+    uint8_t boost = analyzer.isBeat() ? 64 : 0;
+
+    for (uint8_t b = 0; b < DDAudioAnalyzer::NUM_BANDS; b++) {
+        uint16_t first = size * b / DDAudioAnalyzer::NUM_BANDS;
+        uint16_t end = size * (b + 1) / DDAudioAnalyzer::NUM_BANDS;
+        uint16_t level = analyzer.getLevel(b) + boost;
+        uint8_t rgb[3];
+        hueToRGB(b * 300 / DDAudioAnalyzer::NUM_BANDS, level > 255 ? 255 : level, rgb);
+        for (uint16_t i = first; i < end; i++) {
+            _frame.setPixel(i, rgb[0], rgb[1], rgb[2]);
+        }
+    }
+}
+
+uint32_t DDAudioVisualizer::getLatency() const
+{
+    return _latency;
+}
+
+uint32_t DDAudioVisualizer::getLatencyMax() const
+{
+    return _latencyMax;
+}
+
+uint32_t DDAudioVisualizer::getDroppedBlocks() const
+{
+    return _dropped;
+}
@@ -0,0 +1,139 @@
+/*
+ * DDAudio.h - Audio reactive LED output for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDAUDIO_H
+#define DD_BOOSTER_DDAUDIO_H
+
+#include "DDFrameBuffer.h"
+
+/**
+ * @brief Spectrum analysis and beat detection of audio blocks in fixed point.
+ *
+ * Each block of BLOCK_SIZE signed 16 bit samples is windowed and transformed with a radix-2
+ * FFT in Q15 arithmetic. The spectrum is summed into NUM_BANDS logarithmically spaced bands.
+ * Every band follows its own slowly decaying peak, so the band levels (0 - 255) adapt to
+ * the input volume. A beat is detected when the energy of the two lowest bands rises clearly
+ * above its running average, the next one only after it fell below again.
+ */
+class DDAudioAnalyzer {
+public:
+
+    /**
+     * Number of samples per block.
+     */
+    static const uint16_t BLOCK_SIZE = 128;
+
+    /**
+     * Number of frequency bands.
+     */
+    static const uint8_t NUM_BANDS = 8;
+
+    DDAudioAnalyzer();
+
+    /**
+     * Analyzes one block of samples.
+     * @param samples - BLOCK_SIZE signed 16 bit mono samples
+     */
+    void analyze(const int16_t *samples);
+
+    /**
+     * Returns the level of a band after the last analyze() call.
+     * @param band - Band index (0 - NUM_BANDS-1), 0 is the lowest frequency
+     * @return level (0 - 255)
+     */
+    uint8_t getLevel(uint8_t band) const;
+
+    /**
+     * Returns true if a beat was detected in the last block.
+     */
+    bool isBeat() const;
+
+private:
+    void fft();
+
+    int16_t _re[BLOCK_SIZE];
+    int16_t _im[BLOCK_SIZE];
+    uint32_t _peak[NUM_BANDS];
+    uint8_t _level[NUM_BANDS];
+    uint32_t _bassAverage;
+    uint8_t _sinceBeat;
+    bool _bassHigh;
+    bool _beat;
+};
+
+/**
+ * @brief Renders the analyzer results as colored segments and sends them with low latency.
+ *
+ * The strip is divided into one segment per band, each segment has the hue of its band and
+ * the brightness of its level. A beat brightens all segments. Each segment has one color,
+ * so the frame buffer sends it with a single range command.
+ *
+ * push() stores the newest audio block, it can be called from an interrupt. poll() analyzes
+ * and displays the newest block only: older blocks not processed yet are replaced, and
+ * blocks older than the latency bound are dropped. The time from push() to the end of
+ * show() is measured for each displayed block.
+ */
+class DDAudioVisualizer {
+public:
+
+    /**
+     * @param frame - Frame buffer to render to
+     */
+    DDAudioVisualizer(DDFrameBuffer &frame);
+
+    /**
+     * Sets the maximal age of a block when its processing starts.
+     * @param bound - Age in microseconds, 0 disables the bound (default)
+     */
+    void setLatencyBound(uint32_t bound);
+
+    /**
+     * Stores an audio block for the next poll(). Can be called from an interrupt.
+     * @param samples - DDAudioAnalyzer::BLOCK_SIZE signed 16 bit mono samples
+     */
+    void push(const int16_t *samples);
+
+    /**
+     * Analyzes the newest block and sends the resulting frame. Call it from the main loop.
+     * @return true if a frame was sent
+     */
+    bool poll();
+
+    /**
+     * Renders the results of an analyzer into the frame buffer without sending it.
+     * @param analyzer - Analyzer with the results of the last block
+     */
+    void render(const DDAudioAnalyzer &analyzer);
+
+    /**
+     * Returns the latency of the last displayed block from push() to the end of show() in microseconds.
+     */
+    uint32_t getLatency() const;
+
+    /**
+     * Returns the maximal latency measured in microseconds.
+     */
+    uint32_t getLatencyMax() const;
+
+    /**
+     * Returns the number of blocks replaced or dropped before they were displayed.
+     */
+    uint32_t getDroppedBlocks() const;
+
+private:
+    DDFrameBuffer &_frame;
+    DDAudioAnalyzer _analyzer;
+    uint32_t _bound;
+    volatile bool _pending;
+    volatile uint32_t _pushedAt;
+    uint32_t _latency;
+    uint32_t _latencyMax;
+    uint32_t _dropped;
+    int16_t _block[DDAudioAnalyzer::BLOCK_SIZE];
+    int16_t _work[DDAudioAnalyzer::BLOCK_SIZE];
+};
+
+#endif //DD_BOOSTER_DDAUDIO_H
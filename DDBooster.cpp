@@ -6,30 +6,14 @@
  */
 
 #include "DDBooster.h"
-
-#define BOOSTER_CMD_DELAY    500
-#define BOOSTER_LED_DELAY    30
-
-#define BOOSTER_SETRGB       0xA1
-#define BOOSTER_SETRGBW      0xA2
-#define BOOSTER_SETHSV       0xA3
-#define BOOSTER_SETLED       0xA4
-#define BOOSTER_SETALL       0xA5
-#define BOOSTER_SETRANGE     0xA6
-#define BOOSTER_SETRAINBOW   0xA7
-#define BOOSTER_GRADIENT     0xA8
-
-#define BOOSTER_INIT         0xB1
-#define BOOSTER_SHOW         0xB2
-#define BOOSTER_SHIFTUP      0xB3
-#define BOOSTER_SHIFTDOWN    0xB4
-#define BOOSTER_COPYLED      0xB5
-#define BOOSTER_REPEAT       0xB6
-
-#define BOOSTER_RGBORDER     0xC1
+#include "DDBoosterProtocol.h"
 
 DDBooster::DDBooster(PinName MOSI, PinName SCK, PinName CS, PinName RESET)
     : _lastIndex(0)
+    , _deferred(false)
+    , _readyAt(0)
+    , _transferMode(TRANSFER_BYTES)
+    , _waitTime(0)
     , _device(MOSI, NC, SCK)
     , _cs(CS, 1)
     , _reset(RESET, 1)
@@ -66,6 +50,14 @@ void DDBooster::init(uint16_t ledCount, LedType ledType, LedColorOrder colorOrde
     wait_ms(40);
 }
 
+void DDBooster::resume(uint16_t ledCount)
+{
+    if (ledCount > 256) {
+        ledCount = 256;
+    }
+    _lastIndex = ledCount - 1;
+}
+
 void DDBooster::reset()
 {
     if (_reset.is_connected()) {
@@ -126,6 +118,23 @@ void DDBooster::setLED(uint8_t index)
     sendRawBytes(cmd, sizeof (cmd));
 }
 
+void DDBooster::setLED(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (index > _lastIndex) {
+        return;
+    }
+    // optimization by sending two commands in one transaction
+    uint8_t cmd[] = {
+        BOOSTER_SETRGB,
+        r,
+        g,
+        b,
+        BOOSTER_SETLED,
+        index
+    };
+    sendRawBytes(cmd, sizeof (cmd));
+}
+
 void DDBooster::clearLED(uint8_t index)
 {
     if (index > _lastIndex) {
@@ -175,6 +184,24 @@ void DDBooster::setRange(uint8_t start, uint8_t end)
     sendRawBytes(cmd, sizeof (cmd));
 }
 
+void DDBooster::setRange(uint8_t start, uint8_t end, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (start > end || end > _lastIndex || start > _lastIndex) {
+        return;
+    }
+    // optimization by sending two commands in one transaction
+    uint8_t cmd[] = {
+        BOOSTER_SETRGB,
+        r,
+        g,
+        b,
+        BOOSTER_SETRANGE,
+        start,
+        end
+    };
+    sendRawBytes(cmd, sizeof (cmd));
+}
+
 void DDBooster::setRainbow(uint16_t h, uint8_t s, uint8_t v, uint8_t start, uint8_t end, uint8_t step)
 {
     if (start > end || end > _lastIndex || start > _lastIndex) {
@@ -235,7 +262,7 @@ void DDBooster::shiftUp(uint8_t start, uint8_t end, uint8_t count)
         return;
     }
     uint8_t cmd[4] = {
-        BOOSTER_SHIFTDOWN,
+        BOOSTER_SHIFTUP,
         start,
         end,
         count
@@ -288,15 +315,140 @@ void DDBooster::show()
 {
     uint8_t cmd[] = {BOOSTER_SHOW};
     sendRawBytes(cmd, sizeof (cmd));
-    wait_us(BOOSTER_LED_DELAY * (_lastIndex + 1));
+    waitForUpdate();
+}
+
+void DDBooster::waitForUpdate()
+{
+    if (_deferred) {
+        _readyAt += BOOSTER_LED_DELAY * (_lastIndex + 1);
+    } else {
+        pause(BOOSTER_LED_DELAY * (_lastIndex + 1));
+    }
 }
 
 void DDBooster::sendRawBytes(const uint8_t *buffer, uint8_t length)
 {
+    if (_deferred) {
+        int32_t remaining = _readyAt - us_ticker_read();
+        if (remaining > 0) {
+            pause(remaining);
+        }
+    }
+
     _cs = 0;
-    for (int i = 0; i < length; i++) {
-        _device.write(buffer[i]);
+    if (_transferMode == TRANSFER_BLOCK) {
+        _device.write((const char *) buffer, length, NULL, 0);
+    } else {
+        for (int i = 0; i < length; i++) {
+            _device.write(buffer[i]);
+        }
     }
     _cs = 1;
-    wait_us(BOOSTER_CMD_DELAY);
+
+    for (uint8_t i = 0; i < MAX_MONITORS; i++) {
+        if (_monitors[i]) {
+            _monitors[i](buffer, length);
+        }
+    }
+
+    if (_deferred) {
+        _readyAt = us_ticker_read() + BOOSTER_CMD_DELAY;
+    } else {
+        pause(BOOSTER_CMD_DELAY);
+    }
+}
+
+void DDBooster::pause(uint32_t us)
+{
+    wait_us(us);
+    _waitTime += us;
+}
+
+uint16_t DDBooster::getLedCount() const
+{
+    return _lastIndex + 1;
+}
+
+void DDBooster::setDeferredDelays(bool deferred)
+{
+    if (_deferred && !deferred) {
+        // the delay of the last command may still be running
+        int32_t remaining = _readyAt - us_ticker_read();
+        if (remaining > 0) {
+            pause(remaining);
+        }
+    }
+    _deferred = deferred;
+    _readyAt = us_ticker_read();
+}
+
+void DDBooster::setTransferMode(TransferMode mode)
+{
+    _transferMode = mode;
+}
+
+uint32_t DDBooster::getWaitTime() const
+{
+    return _waitTime;
+}
+
+int8_t DDBooster::attachMonitor(Callback<void(const uint8_t *, uint8_t)> monitor)
+{
+    for (uint8_t i = 0; i < MAX_MONITORS; i++) {
+        if (!_monitors[i]) {
+            _monitors[i] = monitor;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void DDBooster::detachMonitor(int8_t handle)
+{
+    if (handle >= 0 && handle < MAX_MONITORS) {
+        _monitors[handle] = Callback<void(const uint8_t *, uint8_t)>();
+    }
+}
+
+uint8_t DDBooster::getCommandSize(uint8_t command)
+{
+    switch (command) {
+    case BOOSTER_SETRGB: return 4;
+    case BOOSTER_SETRGBW: return 5;
+    case BOOSTER_SETHSV: return 5;
+    case BOOSTER_SETLED: return 2;
+    case BOOSTER_SETALL: return 1;
+    case BOOSTER_SETRANGE: return 3;
+    case BOOSTER_SETRAINBOW: return 8;
+    case BOOSTER_INIT: return 3;
+    case BOOSTER_SHOW: return 1;
+    case BOOSTER_SHIFTUP: return 4;
+    case BOOSTER_SHIFTDOWN: return 4;
+    case BOOSTER_COPYLED: return 3;
+    case BOOSTER_REPEAT: return 4;
+    case BOOSTER_RGBORDER: return 4;
+    default: return 0;
+    }
+}
+
+bool DDBooster::containsShow(const uint8_t *data, uint8_t length)
+{
+    uint8_t i = 0;
+    while (i < length) {
+        if (data[i] == BOOSTER_SHOW) {
+            return true;
+        }
+        uint8_t size = getCommandSize(data[i]);
+        if (size == 0) {
+            return false;
+        }
+        i += size;
+    }
+    return false;
+}
+
+bool DDBooster::isReady() const
+{
+    return !_deferred || (int32_t) (us_ticker_read() - _readyAt) >= 0;
 }
@@ -45,6 +45,21 @@ public:
         ORDER_GRB
     };
 
+    /**
+     * How the bytes of a transaction are written to SPI.
+     * TRANSFER_BYTES writes byte by byte and is the default.
+     * TRANSFER_BLOCK writes the whole transaction with one SPI call.
+     */
+    enum TransferMode {
+        TRANSFER_BYTES,
+        TRANSFER_BLOCK
+    };
+
+    /**
+     * Maximal number of monitors attached at the same time.
+     */
+    static const uint8_t MAX_MONITORS = 4;
+
     /**
      * Default constructor. Initializes SPI interface at 12MHz, MSB first, mode 0
      * Assigns used pins for SPI communication and reset pin to reset DD-Booster.
@@ -66,6 +81,13 @@ public:
      */
     void init(uint16_t ledCount, LedType ledType = LED_RGB, LedColorOrder colorOrder = ORDER_GRB);
 
+    /**
+     * Sets the number of LEDs without sending anything, for a DD-Booster which was already
+     * initialized with init() before the MCU restarted.
+     * @param ledCount - Number of used LEDs
+     */
+    void resume(uint16_t ledCount);
+
     /**
      * Performs a hardware reset of the DD-Booster by toggling it's RESET pin.
      * To use this function, set the corresponding pin first using configurePins otherwise
@@ -107,6 +129,17 @@ public:
      */
     void setLED(uint8_t index);
 
+    /**
+     * Sets the color of a single LED using RGB format. The color stays active
+     * for next operations like after a setRGB call.
+     * Internally it sends setRGB(r,g,b) and setLED(index) in one transaction.
+     * @param index - Index of of the LED to set. Index starts with 0
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    void setLED(uint8_t index, uint8_t r, uint8_t g, uint8_t b);
+
     /**
      * Clears a single LED by setting its color to RGB(0,0,0).
      * Internally it simply sends setRGB(0,0,0) and setLED(index).
@@ -132,6 +165,18 @@ public:
      */
     void setRange(uint8_t start, uint8_t end);
 
+    /**
+     * Sets the color of a range of LEDs using RGB format. The color stays active
+     * for next operations like after a setRGB call.
+     * Internally it sends setRGB(r,g,b) and setRange(start, end) in one transaction.
+     * @param start - Index of the first LED in the range to set. Index starts with 0
+     * @param end - Index of the last LED in the range to set
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    void setRange(uint8_t start, uint8_t end, uint8_t r, uint8_t g, uint8_t b);
+
     /**
      * Creates a rainbow effect in a range.
      * @param h - Hue part of the color value (0 - 359)
@@ -191,12 +236,89 @@ public:
     void show();
     
     /**
-     * Sends raw byte buffer with commands to DD-Booster. Waits 2ms after transmission.
+     * Sends raw byte buffer with commands to DD-Booster. Waits 500us after transmission,
+     * with deferred delays before the next transmission.
      */
     void sendRawBytes(const uint8_t* buffer, uint8_t length);
 
+    /**
+     * Waits until the LEDs are updated after a SHOW command sent with sendRawBytes(), like
+     * show() does. With deferred delays the wait is added to the delay of the next command.
+     */
+    void waitForUpdate();
+
+    /**
+     * Returns the number of LEDs configured by the last init() call.
+     */
+    uint16_t getLedCount() const;
+
+    /**
+     * Enables or disables deferred delays. By default every command waits until the DD-Booster
+     * has processed it and show() waits until the LEDs are updated. With deferred delays the
+     * functions return right after the transmission, the next command only waits for the
+     * remaining time. Use isReady() to do other work instead of waiting.
+     * @param deferred - true to defer the delays
+     */
+    void setDeferredDelays(bool deferred);
+
+    /**
+     * Returns true if the DD-Booster has processed the last command and the next command
+     * is sent without waiting.
+     */
+    bool isReady() const;
+
+    /**
+     * Selects how transactions are written to SPI. TRANSFER_BYTES is default.
+     * @param mode - Transfer mode
+     */
+    void setTransferMode(TransferMode mode);
+
+    /**
+     * Returns the total time spent waiting for the DD-Booster in microseconds: the command
+     * and LED update delays, with deferred delays only the remaining waits.
+     */
+    uint32_t getWaitTime() const;
+
+    /**
+     * Adds a function called with the bytes of every transaction after it was sent, e.g. to
+     * record or emulate the traffic. Several monitors can be attached, each one is removed
+     * with the handle returned here. Attach and detach monitors while no other thread sends.
+     * @param monitor - Function receiving the bytes and their number
+     * @return handle for detachMonitor() or -1 if MAX_MONITORS are already attached
+     */
+    int8_t attachMonitor(Callback<void(const uint8_t *, uint8_t)> monitor);
+
+    /**
+     * Removes a monitor added with attachMonitor().
+     * @param handle - Handle returned by attachMonitor(), -1 is ignored
+     */
+    void detachMonitor(int8_t handle);
+
+    /**
+     * Returns the number of bytes of a command including the command byte.
+     * @param command - Command byte
+     * @return size of the command or 0 for unknown commands
+     */
+    static uint8_t getCommandSize(uint8_t command);
+
+    /**
+     * Returns true if a transaction contains a SHOW command. The commands are decoded, so
+     * parameters with the value of SHOW are not mistaken for it.
+     * @param data - Bytes of the transaction
+     * @param length - Number of bytes
+     */
+    static bool containsShow(const uint8_t *data, uint8_t length);
+
+private:
+    void pause(uint32_t us);
+
 public:
     uint8_t _lastIndex;
+    bool _deferred;
+    uint32_t _readyAt;
+    TransferMode _transferMode;
+    uint32_t _waitTime;
+    Callback<void(const uint8_t *, uint8_t)> _monitors[MAX_MONITORS];
     SPI _device;
     DigitalOut _cs;
     DigitalOut _reset;
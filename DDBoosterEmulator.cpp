@@ -0,0 +1,173 @@
+/*
+ * DDBoosterEmulator.cpp - Software model of the Digi-Dot-Booster command processing
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDBoosterEmulator.h"
+#include "DDBoosterProtocol.h"
+
+DDBoosterEmulator::DDBoosterEmulator()
+{
+    reset(MAX_LEDS);
+}
+
+void DDBoosterEmulator::reset(uint16_t ledCount)
+{
+    _ledCount = ledCount > MAX_LEDS ? MAX_LEDS : ledCount;
+    memset(_color, 0, sizeof (_color));
+    memset(_leds, 0, sizeof (_leds));
+    memset(_shown, 0, sizeof (_shown));
+    _bytes = 0;
+    _transactions = 0;
+    _time = 0;
+    _errors = 0;
+}
+
+void DDBoosterEmulator::process(const uint8_t *data, uint8_t length)
+{
+    _bytes += length;
+    _transactions++;
+    // 12MHz SPI clock: 8 bits take 2/3 us
+    _time += BOOSTER_CMD_DELAY + length * 2 / 3;
+
+    uint8_t i = 0;
+    while (i < length) {
+        const uint8_t *p = data + i;
+        uint8_t remaining = length - i;
+        uint8_t size = DDBooster::getCommandSize(p[0]);
+        if (size == 0 || size > remaining) {
+            _errors++;
+            return;
+        }
+
+        switch (p[0]) {
+        case BOOSTER_SETRGB:
+        case BOOSTER_SETRGBW:
+            memcpy(_color, p + 1, 3);
+            break;
+        case BOOSTER_SETHSV:
+            hsv(p[1] | (p[2] << 8), p[3], p[4], _color);
+            break;
+        case BOOSTER_SETLED:
+            set(p[1], _color);
+            break;
+        case BOOSTER_SETALL:
+            for (uint16_t k = 0; k < _ledCount; k++) {
+                set(k, _color);
+            }
+            break;
+        case BOOSTER_SETRANGE:
+            for (uint16_t k = p[1]; k <= p[2]; k++) {
+                set(k, _color);
+            }
+            break;
+        case BOOSTER_SETRAINBOW: {
+            uint16_t h = p[1] | (p[2] << 8);
+            uint8_t rgb[3];
+            for (uint16_t k = p[5]; k <= p[6]; k++) {
+                hsv((h + (k - p[5]) * p[7]) % 360, p[3], p[4], rgb);
+                set(k, rgb);
+            }
+            break;
+        }
+        case BOOSTER_INIT: {
+            uint16_t count = p[1] ? p[1] : MAX_LEDS;
+            _ledCount = count;
+            memset(_leds, 0, sizeof (_leds));
+            break;
+        }
+        case BOOSTER_SHOW:
+            memcpy(_shown, _leds, sizeof (_shown));
+            _time += BOOSTER_LED_DELAY * _ledCount;
+            break;
+        case BOOSTER_SHIFTUP:
+            for (int16_t k = p[2]; k >= p[1] + p[3]; k--) {
+                set(k, _leds + (k - p[3]) * 3);
+            }
+            break;
+        case BOOSTER_SHIFTDOWN:
+            for (uint16_t k = p[1]; k + p[3] <= p[2]; k++) {
+                set(k, _leds + (k + p[3]) * 3);
+            }
+            break;
+        case BOOSTER_COPYLED:
+            set(p[2], _leds + p[1] * 3);
+            break;
+        case BOOSTER_REPEAT: {
+            uint16_t period = p[2] - p[1] + 1;
+            for (uint16_t k = 0; k < period * p[3] && p[2] + 1 + k < MAX_LEDS; k++) {
+                set(p[2] + 1 + k, _leds + (p[1] + k % period) * 3);
+            }
+            break;
+        }
+        default:
+            // RGBORDER changes the output order only, the buffer stays RGB
+            break;
+        }
+        i += size;
+    }
+}
+
+void DDBoosterEmulator::set(uint16_t index, const uint8_t *rgb)
+{
+    if (index < _ledCount) {
+        memcpy(_leds + index * 3, rgb, 3);
+    }
+}
+
+void DDBoosterEmulator::hsv(uint16_t h, uint8_t s, uint8_t v, uint8_t *rgb) const
+{
+    if (h > 359) {
+        h = 359;
+    }
+    uint8_t sector = h / 60;
+    uint16_t f = (h % 60) * 255 / 60;
+    uint8_t p = v * (255 - s) / 255;
+    uint8_t q = v * (255 - s * f / 255) / 255;
+    uint8_t t = v * (255 - s * (255 - f) / 255) / 255;
+    switch (sector) {
+    case 0: rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+    case 1: rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+    case 2: rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+    case 3: rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+    case 4: rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+    default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+    }
+}
+
+const uint8_t *DDBoosterEmulator::getLED(uint16_t index) const
+{
+    return _leds + (index < MAX_LEDS ? index : MAX_LEDS - 1) * 3;
+}
+
+const uint8_t *DDBoosterEmulator::getShown(uint16_t index) const
+{
+    return _shown + (index < MAX_LEDS ? index : MAX_LEDS - 1) * 3;
+}
+
+uint16_t DDBoosterEmulator::getLedCount() const
+{
+    return _ledCount;
+}
+
+uint32_t DDBoosterEmulator::getBytes() const
+{
+    return _bytes;
+}
+
+uint32_t DDBoosterEmulator::getTransactions() const
+{
+    return _transactions;
+}
+
+uint32_t DDBoosterEmulator::getTime() const
+{
+    return _time;
+}
+
+uint32_t DDBoosterEmulator::getErrors() const
+{
+    return _errors;
+}
@@ -0,0 +1,99 @@
+/*
+ * DDBoosterEmulator.h - Software model of the Digi-Dot-Booster command processing
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDBOOSTEREMULATOR_H
+#define DD_BOOSTER_DDBOOSTEREMULATOR_H
+
+#include "DDBooster.h"
+
+/**
+ * @brief Executes DD-Booster commands on a copy of the LED buffer.
+ *
+ * The emulator decodes the bytes of each transaction like the DD-Booster and keeps the
+ * LED buffer and the state shown by the last SHOW. Connect it to a DDBooster with
+ * DDBooster::attachMonitor() and process(), or feed it recorded command streams.
+ * The transferred bytes, transactions and the resulting bus time are counted.
+ *
+ * HSV colors (setHSV, setRainbow) are converted with a standard six sector formula, which
+ * may differ slightly from the DD-Booster firmware. Shift commands keep the values of the
+ * LEDs they leave behind.
+ */
+class DDBoosterEmulator {
+public:
+
+    /**
+     * Maximal number of LEDs supported by the DD-Booster.
+     */
+    static const uint16_t MAX_LEDS = 256;
+
+    DDBoosterEmulator();
+
+    /**
+     * Clears all LEDs and counters, like a DD-Booster after reset and init.
+     * @param ledCount - Number of LEDs
+     */
+    void reset(uint16_t ledCount);
+
+    /**
+     * Executes the commands of one transaction.
+     * @param data - Bytes of the transaction
+     * @param length - Number of bytes
+     */
+    void process(const uint8_t *data, uint8_t length);
+
+    /**
+     * Returns the color of a LED in the buffer as RGB triplet.
+     * @param index - LED index
+     */
+    const uint8_t *getLED(uint16_t index) const;
+
+    /**
+     * Returns the color of a LED as shown by the last SHOW command as RGB triplet.
+     * @param index - LED index
+     */
+    const uint8_t *getShown(uint16_t index) const;
+
+    /**
+     * Returns the number of LEDs set by the last INIT command or reset().
+     */
+    uint16_t getLedCount() const;
+
+    /**
+     * Returns the number of bytes received since reset().
+     */
+    uint32_t getBytes() const;
+
+    /**
+     * Returns the number of transactions received since reset().
+     */
+    uint32_t getTransactions() const;
+
+    /**
+     * Returns the bus time of the received commands in microseconds, including the
+     * command delays and the LED update after each SHOW.
+     */
+    uint32_t getTime() const;
+
+    /**
+     * Returns the number of unknown or truncated commands since reset().
+     */
+    uint32_t getErrors() const;
+
+private:
+    void hsv(uint16_t h, uint8_t s, uint8_t v, uint8_t *rgb) const;
+    void set(uint16_t index, const uint8_t *rgb);
+
+    uint16_t _ledCount;
+    uint8_t _color[3];
+    uint8_t _leds[MAX_LEDS * 3];
+    uint8_t _shown[MAX_LEDS * 3];
+    uint32_t _bytes;
+    uint32_t _transactions;
+    uint32_t _time;
+    uint32_t _errors;
+};
+
+#endif //DD_BOOSTER_DDBOOSTEREMULATOR_H
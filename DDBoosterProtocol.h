@@ -0,0 +1,31 @@
+/*
+ * DDBoosterProtocol.h - Command codes and timings of the Digi-Dot-Booster SPI protocol
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDBOOSTERPROTOCOL_H
+#define DD_BOOSTER_DDBOOSTERPROTOCOL_H
+
+#define BOOSTER_CMD_DELAY    500
+#define BOOSTER_LED_DELAY    30
+
+#define BOOSTER_SETRGB       0xA1
+#define BOOSTER_SETRGBW      0xA2
+#define BOOSTER_SETHSV       0xA3
+#define BOOSTER_SETLED       0xA4
+#define BOOSTER_SETALL       0xA5
+#define BOOSTER_SETRANGE     0xA6
+#define BOOSTER_SETRAINBOW   0xA7
+#define BOOSTER_GRADIENT     0xA8
+
+#define BOOSTER_INIT         0xB1
+#define BOOSTER_SHOW         0xB2
+#define BOOSTER_SHIFTUP      0xB3
+#define BOOSTER_SHIFTDOWN    0xB4
+#define BOOSTER_COPYLED      0xB5
+#define BOOSTER_REPEAT       0xB6
+
+#define BOOSTER_RGBORDER     0xC1
+
+#endif //DD_BOOSTER_DDBOOSTERPROTOCOL_H
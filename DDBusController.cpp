@@ -0,0 +1,181 @@
+/*
+ * DDBusController.cpp - Drives several SPI buses with Digi-Dot-Boosters in parallel threads
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_RTOS_PRESENT
+
+#include "DDBusController.h"
+
+DDBusController::Bus::Bus()
+    : priority(osPriorityNormal)
+    , depth(0)
+    , busyTime(0)
+    , frames(0)
+{
+}
+
+void DDBusController::Bus::run()
+{
+    while (true) {
+        osEvent event = queue.get();
+        if (event.status != osEventMessage) {
+            continue;
+        }
+        Strip *strip = (Strip *) event.value.p;
+
+        uint32_t start = us_ticker_read();
+        strip->frame->flush();
+        uint32_t time = us_ticker_read() - start;
+
+        core_util_critical_section_enter();
+        busyTime += time;
+        frames++;
+        depth--;
+        strip->busy = false;
+        core_util_critical_section_exit();
+    }
+}
+
+DDBusController::DDBusController(uint8_t workers)
+    : _workerCount(workers < 1 ? 1 : (workers > MAX_WORKERS ? MAX_WORKERS : workers))
+    , _busCount(0)
+    , _stripCount(0)
+    , _statisticsStart(0)
+{
+}
+
+int8_t DDBusController::addBus(osPriority priority)
+{
+    if (_busCount == MAX_BUSES) {
+        return -1;
+    }
+    _buses[_busCount].priority = priority;
+    return _busCount++;
+}
+
+int8_t DDBusController::addStrip(uint8_t bus, DDFrameBuffer &frame, Callback<void(DDFrameBuffer &)> render)
+{
+    if (bus >= _busCount || _stripCount == MAX_STRIPS) {
+        return -1;
+    }
+    Strip &strip = _strips[_stripCount];
+    strip.frame = &frame;
+    strip.render = render;
+    strip.bus = bus;
+    strip.busy = false;
+    strip.dropped = 0;
+    return _stripCount++;
+}
+
+void DDBusController::start()
+{
+    _statisticsStart = us_ticker_read();
+    for (uint8_t i = 0; i < _busCount; i++) {
+        _buses[i].thread.start(callback(&_buses[i], &Bus::run));
+        _buses[i].thread.set_priority(_buses[i].priority);
+    }
+    for (uint8_t i = 0; i < _workerCount; i++) {
+        _workers[i].start(callback(this, &DDBusController::work));
+    }
+}
+
+bool DDBusController::submit(uint8_t strip)
+{
+    if (strip >= _stripCount) {
+        return false;
+    }
+    Strip &s = _strips[strip];
+
+    core_util_critical_section_enter();
+    bool busy = s.busy;
+    if (busy) {
+        s.dropped++;
+    } else {
+        s.busy = true;
+    }
+    core_util_critical_section_exit();
+
+    if (busy) {
+        return false;
+    }
+    // each strip is queued at most once, the queues have room for all strips
+    _work.put(&s);
+    return true;
+}
+
+void DDBusController::submitAll()
+{
+    for (uint8_t i = 0; i < _stripCount; i++) {
+        submit(i);
+    }
+}
+
+void DDBusController::work()
+{
+    while (true) {
+        osEvent event = _work.get();
+        if (event.status != osEventMessage) {
+            continue;
+        }
+        Strip *strip = (Strip *) event.value.p;
+        strip->render(*strip->frame);
+
+        Bus &bus = _buses[strip->bus];
+        core_util_critical_section_enter();
+        bus.depth++;
+        core_util_critical_section_exit();
+        bus.queue.put(strip);
+    }
+}
+
+uint8_t DDBusController::getBusCount() const
+{
+    return _busCount;
+}
+
+uint8_t DDBusController::getUtilization(uint8_t bus) const
+{
+    if (bus >= _busCount) {
+        return 0;
+    }
+    uint32_t elapsed = us_ticker_read() - _statisticsStart;
+    if (elapsed == 0) {
+        return 0;
+    }
+    uint64_t percent = (uint64_t) _buses[bus].busyTime * 100 / elapsed;
+    return percent > 100 ? 100 : percent;
+}
+
+uint8_t DDBusController::getQueueDepth(uint8_t bus) const
+{
+    return bus < _busCount ? _buses[bus].depth : 0;
+}
+
+uint32_t DDBusController::getFrameCount(uint8_t bus) const
+{
+    return bus < _busCount ? _buses[bus].frames : 0;
+}
+
+uint32_t DDBusController::getDroppedFrames(uint8_t strip) const
+{
+    return strip < _stripCount ? _strips[strip].dropped : 0;
+}
+
+void DDBusController::resetStatistics()
+{
+    core_util_critical_section_enter();
+    _statisticsStart = us_ticker_read();
+    for (uint8_t i = 0; i < _busCount; i++) {
+        _buses[i].busyTime = 0;
+        _buses[i].frames = 0;
+    }
+    for (uint8_t i = 0; i < _stripCount; i++) {
+        _strips[i].dropped = 0;
+    }
+    core_util_critical_section_exit();
+}
+
+#endif // MBED_CONF_RTOS_PRESENT
@@ -0,0 +1,157 @@
+/*
+ * DDBusController.h - Drives several SPI buses with Digi-Dot-Boosters in parallel threads
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDBUSCONTROLLER_H
+#define DD_BOOSTER_DDBUSCONTROLLER_H
+
+#include "DDFrameBuffer.h"
+#include "rtos.h"
+
+/**
+ * @brief Renders frames on a shared worker pool and sends them with one thread per SPI bus.
+ *
+ * A bus is one SPI peripheral with one or more DD-Boosters selected by their CS pins. Each
+ * DD-Booster is represented by a strip: a frame buffer and a render callback filling it.
+ *
+ * submit() queues a strip for rendering. A pool of worker threads renders the queued strips
+ * and passes them to the transmit thread of their bus, which sends the changes with
+ * DDFrameBuffer::flush(). Every bus has its own thread and queue, so buses never wait for
+ * each other. A strip is only queued once: while its frame is rendered or sent, further
+ * submits of this strip are dropped, so a slow strip never delays the other strips.
+ *
+ * Per bus the utilization (time spent sending) and the number of queued strips is available.
+ *
+ * Up to MAX_BUSES buses, as many as the SPI peripherals of larger targets. The transmit
+ * threads spend most of their time waiting for the bus, so the frame rate of each bus does
+ * not drop with the number of buses, see bench/host/bus_scaling.cpp. A bus costs its thread
+ * stack once it is started, unused bus slots only their thread and queue objects.
+ */
+class DDBusController {
+public:
+
+    /**
+     * Maximal number of buses.
+     */
+    static const uint8_t MAX_BUSES = 8;
+
+    /**
+     * Maximal number of strips of all buses.
+     */
+    static const uint8_t MAX_STRIPS = 16;
+
+    /**
+     * Maximal number of worker threads.
+     */
+    static const uint8_t MAX_WORKERS = 2;
+
+    /**
+     * @param workers - Number of worker threads (1 - MAX_WORKERS)
+     */
+    DDBusController(uint8_t workers = MAX_WORKERS);
+
+    /**
+     * Adds a bus. Must be called before start().
+     * @param priority - Priority of the transmit thread
+     * @return bus index or -1 if MAX_BUSES are already used
+     */
+    int8_t addBus(osPriority priority = osPriorityNormal);
+
+    /**
+     * Adds a strip to a bus. Must be called before start().
+     * @param bus - Bus index returned by addBus()
+     * @param frame - Frame buffer of the DD-Booster on this bus
+     * @param render - Callback rendering the next frame into the frame buffer
+     * @return strip index or -1 if the bus is invalid or MAX_STRIPS are already used
+     */
+    int8_t addStrip(uint8_t bus, DDFrameBuffer &frame, Callback<void(DDFrameBuffer &)> render);
+
+    /**
+     * Starts the worker and transmit threads.
+     */
+    void start();
+
+    /**
+     * Queues a strip for rendering and sending. Can be called from any thread.
+     * @param strip - Strip index returned by addStrip()
+     * @return false if the previous frame of the strip is still in progress and this one is dropped
+     */
+    bool submit(uint8_t strip);
+
+    /**
+     * Queues all strips, see submit().
+     */
+    void submitAll();
+
+    /**
+     * Returns the number of buses added with addBus().
+     */
+    uint8_t getBusCount() const;
+
+    /**
+     * Returns the part of the time the bus was sending since the last resetStatistics() call.
+     * @param bus - Bus index
+     * @return utilization in percent
+     */
+    uint8_t getUtilization(uint8_t bus) const;
+
+    /**
+     * Returns the number of strips rendered and waiting for the bus.
+     * @param bus - Bus index
+     */
+    uint8_t getQueueDepth(uint8_t bus) const;
+
+    /**
+     * Returns the number of frames sent on the bus since the last resetStatistics() call.
+     * @param bus - Bus index
+     */
+    uint32_t getFrameCount(uint8_t bus) const;
+
+    /**
+     * Returns the number of dropped submits of a strip since the last resetStatistics() call.
+     * @param strip - Strip index
+     */
+    uint32_t getDroppedFrames(uint8_t strip) const;
+
+    /**
+     * Resets the utilization, frame and drop counters.
+     */
+    void resetStatistics();
+
+private:
+    struct Strip {
+        DDFrameBuffer *frame;
+        Callback<void(DDFrameBuffer &)> render;
+        uint8_t bus;
+        volatile bool busy;
+        volatile uint32_t dropped;
+    };
+
+    class Bus {
+    public:
+        Bus();
+        void run();
+
+        Thread thread;
+        Queue<Strip, MAX_STRIPS> queue;
+        osPriority priority;
+        volatile uint8_t depth;
+        volatile uint32_t busyTime;
+        volatile uint32_t frames;
+    };
+
+    void work();
+
+    Bus _buses[MAX_BUSES];
+    Strip _strips[MAX_STRIPS];
+    Thread _workers[MAX_WORKERS];
+    Queue<Strip, MAX_STRIPS> _work;
+    uint8_t _workerCount;
+    uint8_t _busCount;
+    uint8_t _stripCount;
+    uint32_t _statisticsStart;
+};
+
+#endif //DD_BOOSTER_DDBUSCONTROLLER_H
@@ -0,0 +1,285 @@
+/*
+ * DDBytecode.cpp - Compact bytecode interpreter for looping effects on the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDBytecode.h"
+
+// length in bytes and number of register operands of each instruction, 0 for unknown opcodes,
+// the register operands always follow the opcode
+static const uint8_t ARITHMETIC_FORMAT[][2] = {
+    {1, 0}, // HALT
+    {4, 1}, // LDI
+    {3, 2}, // MOV
+    {3, 2}, // ADD
+    {3, 2}, // SUB
+    {3, 1}, // ADDI
+    {3, 1}, // MULI
+    {3, 1}, // SHRI
+    {4, 1}, // MODI
+    {3, 0}, // JMP
+    {4, 1}, // DJNZ
+    {5, 2}, // JLT
+    {3, 0}, // WAIT
+    {2, 1}  // WAITR
+};
+
+static const uint8_t BOOSTER_FORMAT[][2] = {
+    {4, 3}, // RGB
+    {4, 3}, // HSV
+    {2, 1}, // LED
+    {3, 2}, // RANGE
+    {1, 0}, // ALL
+    {7, 6}, // RAINBOW
+    {4, 3}, // SHIFTUP
+    {4, 3}, // SHIFTDOWN
+    {3, 2}, // COPY
+    {4, 3}, // REPEAT
+    {1, 0}  // SHOW
+};
+
+DDBytecode::DDBytecode(DDBooster &booster)
+    : _booster(booster)
+    , _code(NULL)
+    , _length(0)
+    , _pc(0)
+    , _state(STATE_HALTED)
+    , _fault(false)
+    , _wakeAt(0)
+{
+    memset(_registers, 0, sizeof (_registers));
+    _timer.start();
+}
+
+void DDBytecode::load(const uint8_t *code, uint16_t length)
+{
+    _code = code;
+    _length = length;
+    _pc = 0;
+    _state = STATE_RUNNING;
+}
+
+void DDBytecode::setRegister(uint8_t index, int16_t value)
+{
+    if (index < NUM_REGISTERS) {
+        _registers[index] = value;
+    }
+}
+
+int16_t DDBytecode::getRegister(uint8_t index) const
+{
+    return index < NUM_REGISTERS ? _registers[index] : 0;
+}
+
+DDBytecode::State DDBytecode::step()
+{
+    if (_state == STATE_WAITING) {
+        if ((int32_t) (_timer.read_ms() - _wakeAt) < 0) {
+            return _state;
+        }
+        _state = STATE_RUNNING;
+    }
+
+    for (uint8_t n = 0; n < MAX_INSTRUCTIONS && _state == STATE_RUNNING; n++) {
+        _fault = false;
+        if (!decode()) {
+            _state = STATE_ERROR;
+            break;
+        }
+        const uint8_t *op = _code + _pc;
+        bool shown = false;
+
+        switch (op[0]) {
+        case OP_HALT:
+            _state = STATE_HALTED;
+            break;
+        case OP_LDI:
+            reg(op[1]) = imm16(2);
+            _pc += 4;
+            break;
+        case OP_MOV:
+            reg(op[1]) = reg(op[2]);
+            _pc += 3;
+            break;
+        case OP_ADD:
+            reg(op[1]) += reg(op[2]);
+            _pc += 3;
+            break;
+        case OP_SUB:
+            reg(op[1]) -= reg(op[2]);
+            _pc += 3;
+            break;
+        case OP_ADDI:
+            reg(op[1]) += (int8_t) op[2];
+            _pc += 3;
+            break;
+        case OP_MULI:
+            reg(op[1]) *= op[2];
+            _pc += 3;
+            break;
+        case OP_SHRI:
+            reg(op[1]) >>= op[2] & 0x0F;
+            _pc += 3;
+            break;
+        case OP_MODI: {
+            int32_t m = imm16(2);
+            if (m <= 0) {
+                _fault = true;
+                break;
+            }
+            int16_t &r = reg(op[1]);
+            r = ((r % m) + m) % m;
+            _pc += 4;
+            break;
+        }
+        case OP_JMP:
+            jump(imm16(1));
+            break;
+        case OP_DJNZ:
+            if (--reg(op[1]) != 0) {
+                jump(imm16(2));
+            } else {
+                _pc += 4;
+            }
+            break;
+        case OP_JLT:
+            if (reg(op[1]) < reg(op[2])) {
+                jump(imm16(3));
+            } else {
+                _pc += 5;
+            }
+            break;
+        case OP_WAIT:
+            wait(imm16(1));
+            _pc += 3;
+            break;
+        case OP_WAITR:
+            wait(reg(op[1]));
+            _pc += 2;
+            break;
+        case OP_RGB:
+            _booster.setRGB(reg(op[1]), reg(op[2]), reg(op[3]));
+            _pc += 4;
+            break;
+        case OP_HSV:
+            _booster.setHSV(reg(op[1]), reg(op[2]), reg(op[3]));
+            _pc += 4;
+            break;
+        case OP_LED:
+            _booster.setLED(reg(op[1]));
+            _pc += 2;
+            break;
+        case OP_RANGE:
+            _booster.setRange(reg(op[1]), reg(op[2]));
+            _pc += 3;
+            break;
+        case OP_ALL:
+            _booster.setAll();
+            _pc += 1;
+            break;
+        case OP_RAINBOW:
+            _booster.setRainbow(reg(op[1]), reg(op[2]), reg(op[3]), reg(op[4]), reg(op[5]), reg(op[6]));
+            _pc += 7;
+            break;
+        case OP_SHIFTUP:
+            _booster.shiftUp(reg(op[1]), reg(op[2]), reg(op[3]));
+            _pc += 4;
+            break;
+        case OP_SHIFTDOWN:
+            _booster.shiftDown(reg(op[1]), reg(op[2]), reg(op[3]));
+            _pc += 4;
+            break;
+        case OP_COPY:
+            _booster.copyLED(reg(op[1]), reg(op[2]));
+            _pc += 3;
+            break;
+        case OP_REPEAT:
+            _booster.repeat(reg(op[1]), reg(op[2]), reg(op[3]));
+            _pc += 4;
+            break;
+        case OP_SHOW:
+            _booster.show();
+            _pc += 1;
+            shown = true;
+            break;
+        }
+
+        if (_fault) {
+            // the program counter stays at the failing instruction
+            _state = STATE_ERROR;
+        }
+        if (shown) {
+            break;
+        }
+    }
+    return _state;
+}
+
+bool DDBytecode::decode() const
+{
+    if (_code == NULL || _pc >= _length) {
+        return false;
+    }
+
+    // the whole instruction is checked before it is executed, so a broken program
+    // never sends a command with invalid operands
+    uint8_t opcode = _code[_pc];
+    const uint8_t *format;
+    if (opcode <= OP_WAITR) {
+        format = ARITHMETIC_FORMAT[opcode];
+    } else if (opcode >= OP_RGB && opcode <= OP_SHOW) {
+        format = BOOSTER_FORMAT[opcode - OP_RGB];
+    } else {
+        return false;
+    }
+
+    if ((uint32_t) _pc + format[0] > _length) {
+        return false;
+    }
+    for (uint8_t i = 1; i <= format[1]; i++) {
+        if (_code[_pc + i] >= NUM_REGISTERS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int16_t &DDBytecode::reg(uint8_t operand)
+{
+    return _registers[operand];
+}
+
+uint16_t DDBytecode::imm16(uint8_t offset) const
+{
+    return _code[_pc + offset] | (_code[_pc + offset + 1] << 8);
+}
+
+bool DDBytecode::jump(uint16_t target)
+{
+    if (target >= _length) {
+        _fault = true;
+        return false;
+    }
+    _pc = target;
+    return true;
+}
+
+void DDBytecode::wait(int32_t ms)
+{
+    if (ms > 0) {
+        _wakeAt = _timer.read_ms() + ms;
+        _state = STATE_WAITING;
+    }
+}
+
+DDBytecode::State DDBytecode::getState() const
+{
+    return _state;
+}
+
+uint16_t DDBytecode::getProgramCounter() const
+{
+    return _pc;
+}
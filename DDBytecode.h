@@ -0,0 +1,174 @@
+/*
+ * DDBytecode.h - Compact bytecode interpreter for looping effects on the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDBYTECODE_H
+#define DD_BOOSTER_DDBYTECODE_H
+
+#include "DDBooster.h"
+
+/**
+ * @brief Executes effect programs in a compact bytecode.
+ *
+ * The interpreter has NUM_REGISTERS signed 16 bit registers. Each instruction is one opcode
+ * byte followed by its operands: register numbers (one byte each, written as r below),
+ * 8 bit immediates (i8, signed for ADDI) or 16 bit immediates (i16, little endian).
+ * Jump targets are absolute code offsets (i16).
+ *
+ *     HALT                      stop the program
+ *     LDI r i16                 r = i16
+ *     MOV r1 r2                 r1 = r2
+ *     ADD r1 r2                 r1 = r1 + r2
+ *     SUB r1 r2                 r1 = r1 - r2
+ *     ADDI r i8                 r = r + i8 (-128 - 127)
+ *     MULI r i8                 r = r * i8
+ *     SHRI r i8                 r = r >> i8
+ *     MODI r i16                r = r modulo i16, the result is never negative
+ *     JMP i16                   continue at offset i16
+ *     DJNZ r i16                r = r - 1, continue at offset i16 if r is not 0
+ *     JLT r1 r2 i16             continue at offset i16 if r1 < r2
+ *     WAIT i16                  pause for i16 milliseconds
+ *     WAITR r                   pause for r milliseconds
+ *     RGB r1 r2 r3              setRGB(r1, r2, r3)
+ *     HSV r1 r2 r3              setHSV(r1, r2, r3)
+ *     LED r                     setLED(r)
+ *     RANGE r1 r2               setRange(r1, r2)
+ *     ALL                       setAll()
+ *     RAINBOW r1 r2 r3 r4 r5 r6 setRainbow(r1, r2, r3, r4, r5, r6)
+ *     SHIFTUP r1 r2 r3          shiftUp(r1, r2, r3)
+ *     SHIFTDOWN r1 r2 r3        shiftDown(r1, r2, r3)
+ *     COPY r1 r2                copyLED(r1, r2)
+ *     REPEAT r1 r2 r3           repeat(r1, r2, r3)
+ *     SHOW                      show()
+ *
+ * Registers keep their values when a program is (re)started, so the caller can pass parameters
+ * like colors or speeds with setRegister().
+ *
+ * step() never blocks on WAIT and executes at most MAX_INSTRUCTIONS instructions, a SHOW ends
+ * the step as well. This bounds the time of a step even for programs with an endless loop
+ * without waits.
+ *
+ * Example: a rainbow moving along 60 LEDs, the whole loop takes 10 seconds (37 bytes)
+ *
+ *     0:  LDI 1 255               saturation and value
+ *     4:  LDI 2 0                 first LED
+ *     8:  LDI 3 59                last LED
+ *     12: LDI 4 6                 hue step
+ *     16: RAINBOW 0 1 1 2 3 4
+ *     23: SHOW
+ *     24: ADDI 0 6
+ *     27: MODI 0 360
+ *     31: WAIT 166
+ *     34: JMP 16
+ */
+class DDBytecode {
+public:
+
+    enum Opcode {
+        OP_HALT = 0x00,
+        OP_LDI,
+        OP_MOV,
+        OP_ADD,
+        OP_SUB,
+        OP_ADDI,
+        OP_MULI,
+        OP_SHRI,
+        OP_MODI,
+        OP_JMP,
+        OP_DJNZ,
+        OP_JLT,
+        OP_WAIT,
+        OP_WAITR,
+        OP_RGB = 0x20,
+        OP_HSV,
+        OP_LED,
+        OP_RANGE,
+        OP_ALL,
+        OP_RAINBOW,
+        OP_SHIFTUP,
+        OP_SHIFTDOWN,
+        OP_COPY,
+        OP_REPEAT,
+        OP_SHOW
+    };
+
+    enum State {
+        STATE_RUNNING,
+        STATE_WAITING,
+        STATE_HALTED,
+        STATE_ERROR
+    };
+
+    /**
+     * Number of registers.
+     */
+    static const uint8_t NUM_REGISTERS = 16;
+
+    /**
+     * Maximal number of instructions executed by one step() call.
+     */
+    static const uint8_t MAX_INSTRUCTIONS = 64;
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDBytecode(DDBooster &booster);
+
+    /**
+     * Loads a program and starts it at offset 0.
+     * @param code - Program, must stay valid while running
+     * @param length - Length of the program in bytes
+     */
+    void load(const uint8_t *code, uint16_t length);
+
+    /**
+     * Sets a register, e.g. to pass a parameter to the program.
+     * @param index - Register number (0 - NUM_REGISTERS-1)
+     * @param value - New value
+     */
+    void setRegister(uint8_t index, int16_t value);
+
+    /**
+     * Returns the value of a register.
+     * @param index - Register number (0 - NUM_REGISTERS-1)
+     */
+    int16_t getRegister(uint8_t index) const;
+
+    /**
+     * Executes the program until it waits, shows a frame or MAX_INSTRUCTIONS are executed.
+     * Call it from the main loop.
+     * @return the state after the step
+     */
+    State step();
+
+    /**
+     * Returns the current state.
+     */
+    State getState() const;
+
+    /**
+     * Returns the offset of the next instruction, or of the failing one in STATE_ERROR.
+     */
+    uint16_t getProgramCounter() const;
+
+private:
+    bool decode() const;
+    int16_t &reg(uint8_t operand);
+    uint16_t imm16(uint8_t offset) const;
+    bool jump(uint16_t target);
+    void wait(int32_t ms);
+
+    DDBooster &_booster;
+    const uint8_t *_code;
+    uint16_t _length;
+    uint16_t _pc;
+    State _state;
+    bool _fault;
+    int16_t _registers[NUM_REGISTERS];
+    uint32_t _wakeAt;
+    Timer _timer;
+};
+
+#endif //DD_BOOSTER_DDBYTECODE_H
@@ -0,0 +1,250 @@
+/*
+ * DDEffects.cpp - Standard LED effects built on the commands of the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDEffects.h"
+
+DDEffect::DDEffect(DDBooster &booster)
+    : _booster(booster)
+{
+}
+
+DDEffect::~DDEffect()
+{
+}
+
+DDTheaterChase::DDTheaterChase(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t spacing)
+    : DDEffect(booster)
+    , _spacing(spacing < 2 ? 2 : spacing)
+{
+    _color[0] = r;
+    _color[1] = g;
+    _color[2] = b;
+}
+
+void DDTheaterChase::begin()
+{
+    uint16_t ledCount = _booster.getLedCount();
+
+    // draw one period and let the DD-Booster repeat it over the strip
+    _booster.clearAll();
+    _booster.setLED(0, _color[0], _color[1], _color[2]);
+    if (ledCount > _spacing) {
+        _booster.repeat(0, _spacing - 1, (ledCount - 1) / _spacing);
+    }
+    _booster.show();
+}
+
+void DDTheaterChase::step()
+{
+    uint16_t ledCount = _booster.getLedCount();
+    if (ledCount <= _spacing) {
+        return;
+    }
+    _booster.shiftUp(0, ledCount - 1, 1);
+    // the pattern is periodic, LED 0 gets the value of the same position in the next period
+    _booster.copyLED(_spacing, 0);
+    _booster.show();
+}
+
+DDComet::DDComet(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t tail)
+    : DDEffect(booster)
+    , _tail(tail)
+    , _frame(0)
+{
+    _color[0] = r;
+    _color[1] = g;
+    _color[2] = b;
+}
+
+void DDComet::begin()
+{
+    _frame = 0;
+    _booster.clearAll();
+    _booster.setLED(0, _color[0], _color[1], _color[2]);
+    _booster.show();
+}
+
+void DDComet::step()
+{
+    uint16_t ledCount = _booster.getLedCount();
+
+    _frame++;
+    if (_frame >= ledCount + _tail) {
+        // comet and tail left the strip, start again
+        begin();
+        return;
+    }
+
+    _booster.shiftUp(0, ledCount - 1, 1);
+    if (_frame <= _tail) {
+        // the tail is still entering the strip, the last step clears LED 0
+        uint8_t level = _tail - _frame;
+        _booster.setLED(0,
+                        _color[0] * level / (_tail + 1),
+                        _color[1] * level / (_tail + 1),
+                        _color[2] * level / (_tail + 1));
+    }
+    _booster.show();
+}
+
+DDLarsonScanner::DDLarsonScanner(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t radius)
+    : DDEffect(booster)
+    , _radius(radius)
+    , _center(radius)
+    , _up(true)
+{
+    _color[0] = r;
+    _color[1] = g;
+    _color[2] = b;
+}
+
+void DDLarsonScanner::begin()
+{
+    _center = _radius;
+    _up = true;
+
+    _booster.clearAll();
+    for (uint8_t i = 0; i <= _radius; i++) {
+        uint8_t level = _radius + 1 - i;
+        uint8_t r = _color[0] * level / (_radius + 1);
+        uint8_t g = _color[1] * level / (_radius + 1);
+        uint8_t b = _color[2] * level / (_radius + 1);
+        _booster.setLED(_center + i, r, g, b);
+        if (i > 0) {
+            _booster.copyLED(_center + i, _center - i);
+        }
+    }
+    _booster.show();
+}
+
+void DDLarsonScanner::step()
+{
+    uint8_t last = _booster.getLedCount() - 1;
+    if (last < 2 * _radius + 1) {
+        return;
+    }
+
+    if (_up && _center + _radius >= last) {
+        _up = false;
+    } else if (!_up && _center <= _radius) {
+        _up = true;
+    }
+
+    // the shift moves the black LED behind the eye onto the LED it just left, only the end
+    // of the range keeps its color and has to be cleared
+    if (_up) {
+        _booster.shiftUp(0, last, 1);
+        _center++;
+        if (_center - _radius - 1 == 0) {
+            _booster.clearLED(0);
+        }
+    } else {
+        _booster.shiftDown(0, last, 1);
+        _center--;
+        if (_center + _radius + 1 == last) {
+            _booster.clearLED(last);
+        }
+    }
+    _booster.show();
+}
+
+DDColorWipe::DDColorWipe(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b)
+    : DDEffect(booster)
+    , _frame(0)
+{
+    _color[0] = r;
+    _color[1] = g;
+    _color[2] = b;
+}
+
+void DDColorWipe::begin()
+{
+    _frame = 0;
+    _booster.clearAll();
+    _booster.show();
+}
+
+void DDColorWipe::step()
+{
+    uint16_t ledCount = _booster.getLedCount();
+    uint8_t index = _frame % ledCount;
+
+    if (_frame < ledCount) {
+        _booster.setLED(index, _color[0], _color[1], _color[2]);
+    } else {
+        _booster.clearLED(index);
+    }
+    _booster.show();
+
+    _frame++;
+    if (_frame >= 2 * ledCount) {
+        _frame = 0;
+    }
+}
+
+DDRainbowCycle::DDRainbowCycle(DDBooster &booster, uint8_t s, uint8_t v, uint8_t step, uint8_t speed)
+    : DDEffect(booster)
+    , _hue(0)
+    , _s(s)
+    , _v(v)
+    , _step(step)
+    , _speed(speed)
+{
+}
+
+void DDRainbowCycle::begin()
+{
+    _hue = 0;
+    _booster.setRainbow(_hue, _s, _v, 0, _booster.getLedCount() - 1, _step);
+    _booster.show();
+}
+
+void DDRainbowCycle::step()
+{
+    _hue = (_hue + _speed) % 360;
+    _booster.setRainbow(_hue, _s, _v, 0, _booster.getLedCount() - 1, _step);
+    _booster.show();
+}
+
+DDTwinkle::DDTwinkle(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t count)
+    : DDEffect(booster)
+    , _count(count)
+    , _next(0)
+{
+    if (_count < 1) {
+        _count = 1;
+    } else if (_count > MAX_LIT) {
+        _count = MAX_LIT;
+    }
+    _color[0] = r;
+    _color[1] = g;
+    _color[2] = b;
+}
+
+void DDTwinkle::begin()
+{
+    uint16_t ledCount = _booster.getLedCount();
+
+    _booster.clearAll();
+    for (uint8_t i = 0; i < _count; i++) {
+        _lit[i] = rand() % ledCount;
+        _booster.setLED(_lit[i], _color[0], _color[1], _color[2]);
+    }
+    _next = 0;
+    _booster.show();
+}
+
+void DDTwinkle::step()
+{
+    // the slots are used as ring buffer, the oldest LED is replaced
+    _booster.clearLED(_lit[_next]);
+    _lit[_next] = rand() % _booster.getLedCount();
+    _booster.setLED(_lit[_next], _color[0], _color[1], _color[2]);
+    _booster.show();
+
+    _next = (_next + 1) % _count;
+}
@@ -0,0 +1,218 @@
+/*
+ * DDEffects.h - Standard LED effects built on the commands of the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDEFFECTS_H
+#define DD_BOOSTER_DDEFFECTS_H
+
+#include "DDBooster.h"
+
+/**
+ * @brief Base class of the effects.
+ *
+ * Effects do not render the LED colors on the MCU. The DD-Booster keeps the LED state and
+ * each frame only the commands needed to move from one frame to the next are sent, using
+ * the shift, copy, repeat and rainbow functions of the DD-Booster.
+ * The bytes per frame documented for each effect include the SHOW command.
+ *
+ * Call begin() once to draw the first frame and step() for every following frame.
+ * Both functions call show(). The frame rate is controlled by the caller.
+ */
+class DDEffect {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDEffect(DDBooster &booster);
+
+    virtual ~DDEffect();
+
+    /**
+     * Draws the first frame of the effect.
+     */
+    virtual void begin() = 0;
+
+    /**
+     * Draws the next frame of the effect.
+     */
+    virtual void step() = 0;
+
+protected:
+    DDBooster &_booster;
+};
+
+/**
+ * @brief Every n-th LED is lit and the pattern moves up one LED per frame.
+ *
+ * The pattern is created once with one LED and repeat(). Each frame the DD-Booster shifts
+ * the strip up by one LED and the LED falling in at index 0 is copied from the next period.
+ * Bytes per frame: 8 (shiftUp 4, copyLED 3, show 1)
+ */
+class DDTheaterChase : public DDEffect {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     * @param spacing - Distance between two lit LEDs, 3 is default
+     */
+    DDTheaterChase(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t spacing = 3);
+
+    virtual void begin();
+    virtual void step();
+
+private:
+    uint8_t _color[3];
+    uint8_t _spacing;
+};
+
+/**
+ * @brief A comet with a fading tail runs from LED 0 to the end of the strip.
+ *
+ * Each frame the strip is shifted up by one LED. While the comet enters the strip, the
+ * next tail pixel is set at index 0, afterwards the shift alone moves the comet.
+ * Bytes per frame: 11 while entering (shiftUp 4, setLED 6, show 1), 5 otherwise
+ */
+class DDComet : public DDEffect {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     * @param tail - Length of the tail in LEDs
+     */
+    DDComet(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t tail);
+
+    virtual void begin();
+    virtual void step();
+
+private:
+    uint8_t _color[3];
+    uint8_t _tail;
+    uint16_t _frame;
+};
+
+/**
+ * @brief Larson scanner: a glowing eye moving back and forth.
+ *
+ * The eye fades symmetrically to both sides, so it looks the same in both directions and
+ * the DD-Booster can move it with shiftUp/shiftDown, which also moves the black LED behind
+ * the eye onto the LED it left. Only when the eye leaves an end of the strip that LED is
+ * cleared. Bytes per frame: 5 (shift 4, show 1), 11 when leaving an end (clearLED 6)
+ */
+class DDLarsonScanner : public DDEffect {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     * @param radius - Number of fading LEDs on each side of the eye center
+     */
+    DDLarsonScanner(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t radius);
+
+    virtual void begin();
+    virtual void step();
+
+private:
+    uint8_t _color[3];
+    uint8_t _radius;
+    uint8_t _center;
+    bool _up;
+};
+
+/**
+ * @brief Fills the strip LED by LED with a color, then wipes it off the same way.
+ *
+ * Bytes per frame: 7 (setLED 6, show 1)
+ */
+class DDColorWipe : public DDEffect {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    DDColorWipe(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b);
+
+    virtual void begin();
+    virtual void step();
+
+private:
+    uint8_t _color[3];
+    uint16_t _frame;
+};
+
+/**
+ * @brief Moving rainbow over the whole strip.
+ *
+ * The rainbow is calculated by the DD-Booster, each frame sends one setRainbow command
+ * with a moved start hue.
+ * Bytes per frame: 9 (setRainbow 8, show 1)
+ */
+class DDRainbowCycle : public DDEffect {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param s - Saturation part of the color value (0 - 255)
+     * @param v - Value part of the color value (0 - 255)
+     * @param step - Hue increment between 2 LEDs. Recommended values 2 - 20
+     * @param speed - Hue increment per frame
+     */
+    DDRainbowCycle(DDBooster &booster, uint8_t s, uint8_t v, uint8_t step, uint8_t speed);
+
+    virtual void begin();
+    virtual void step();
+
+private:
+    uint16_t _hue;
+    uint8_t _s;
+    uint8_t _v;
+    uint8_t _step;
+    uint8_t _speed;
+};
+
+/**
+ * @brief Random LEDs light up, the oldest one goes off when a new one appears.
+ *
+ * Bytes per frame: 13 (clearLED 6, setLED 6, show 1)
+ */
+class DDTwinkle : public DDEffect {
+public:
+
+    /**
+     * Maximal number of simultaneously lit LEDs.
+     */
+    static const uint8_t MAX_LIT = 32;
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     * @param count - Number of simultaneously lit LEDs (1 - MAX_LIT)
+     */
+    DDTwinkle(DDBooster &booster, uint8_t r, uint8_t g, uint8_t b, uint8_t count);
+
+    virtual void begin();
+    virtual void step();
+
+private:
+    uint8_t _color[3];
+    uint8_t _count;
+    uint8_t _next;
+    uint8_t _lit[MAX_LIT];
+};
+
+#endif //DD_BOOSTER_DDEFFECTS_H
@@ -0,0 +1,76 @@
+/*
+ * DDFont.h - Column based bitmap fonts for the Digi-Dot-Booster text renderer
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDFONT_H
+#define DD_BOOSTER_DDFONT_H
+
+#include <mbed.h>
+
+/**
+ * @brief Bitmap font stored as glyph columns.
+ *
+ * Each glyph consists of width columns, one byte per column. Bit 0 is the top row,
+ * so fonts can be up to 8 pixels high. Scrolling text moves column by column, so this
+ * format allows to fetch the next incoming column with a single table lookup.
+ *
+ * Fonts given as row bitmaps can be converted once with rasterize().
+ * A 5x7 ASCII font is included as DDFont::FONT_5X7.
+ */
+class DDFont {
+public:
+
+    /**
+     * Creates a font from a glyph column table.
+     * @param columns - Glyph columns, width bytes per glyph starting with the first character
+     * @param width - Number of columns of one glyph
+     * @param height - Number of rows of one glyph (1 - 8)
+     * @param first - First character contained in the table
+     * @param last - Last character contained in the table
+     */
+    DDFont(const uint8_t *columns, uint8_t width, uint8_t height, char first, char last);
+
+    /**
+     * Returns one column of a glyph. Characters not contained in the font are blank.
+     * @param c - Character
+     * @param column - Column index of the glyph (0 - width-1)
+     * @return column bits, bit 0 is the top row
+     */
+    uint8_t getColumn(char c, uint8_t column) const;
+
+    /**
+     * Returns the number of columns of one glyph.
+     */
+    uint8_t getWidth() const;
+
+    /**
+     * Returns the number of rows of one glyph.
+     */
+    uint8_t getHeight() const;
+
+    /**
+     * Converts glyphs given as rows to the column format used by DDFont.
+     * @param rows - Source glyphs, height bytes per glyph. The most significant bit is the left column
+     * @param width - Number of columns of one glyph (1 - 8)
+     * @param height - Number of rows of one glyph (1 - 8)
+     * @param glyphCount - Number of glyphs to convert
+     * @param columns - Destination buffer, must hold width * glyphCount bytes
+     */
+    static void rasterize(const uint8_t *rows, uint8_t width, uint8_t height, uint16_t glyphCount, uint8_t *columns);
+
+    /**
+     * Built-in 5x7 font for the printable ASCII characters (32 - 126).
+     */
+    static const DDFont FONT_5X7;
+
+private:
+    const uint8_t *_columns;
+    uint8_t _width;
+    uint8_t _height;
+    char _first;
+    char _last;
+};
+
+#endif //DD_BOOSTER_DDFONT_H
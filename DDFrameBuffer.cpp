@@ -0,0 +1,422 @@
+/*
+ * DDFrameBuffer.cpp - Frame buffer with difference encoding for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDFrameBuffer.h"
+#include "DDBoosterProtocol.h"
+
+static const uint8_t BLACK[3] = {0, 0, 0};
+
+// returns the start of the longest run of one color
+static uint16_t longestRun(const uint8_t *data, uint16_t size)
+{
+    uint16_t bestStart = 0, bestLength = 0;
+    uint16_t start = 0;
+    for (uint16_t i = 1; i <= size; i++) {
+        if (i == size || memcmp(data + i * 3, data + start * 3, 3) != 0) {
+            if (i - start > bestLength) {
+                bestStart = start;
+                bestLength = i - start;
+            }
+            start = i;
+        }
+    }
+    return bestStart;
+}
+
+// marks a completely written retained state
+#define RETAINED_MAGIC       0xDDB0057E
+
+static uint32_t checksum(const DDRetainedState &state)
+{
+    // FNV-1a over everything but the checksum itself
+    const uint8_t *data = (const uint8_t *) &state;
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < offsetof(DDRetainedState, checksum); i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t DDFrameCost::getTime() const
+{
+    // 12MHz SPI clock: 8 bits take 2/3 us
+    return transactions * BOOSTER_CMD_DELAY + bytes * 2 / 3;
+}
+
+DDFrameBuffer::DDFrameBuffer(DDBooster &booster)
+    : _booster(booster)
+    , _valid(false)
+    , _restoreTime(0)
+    , _retained(NULL)
+{
+    memset(_frame, 0, sizeof (_frame));
+    memset(_shown, 0, sizeof (_shown));
+}
+
+void DDFrameBuffer::setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (index >= MAX_LEDS) {
+        return;
+    }
+    uint8_t *px = _frame + index * 3;
+    px[0] = r;
+    px[1] = g;
+    px[2] = b;
+}
+
+void DDFrameBuffer::addPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (index >= MAX_LEDS) {
+        return;
+    }
+    uint8_t *px = _frame + index * 3;
+    uint16_t sum;
+    sum = px[0] + r;
+    px[0] = sum > 255 ? 255 : sum;
+    sum = px[1] + g;
+    px[1] = sum > 255 ? 255 : sum;
+    sum = px[2] + b;
+    px[2] = sum > 255 ? 255 : sum;
+}
+
+const uint8_t *DDFrameBuffer::getPixel(uint16_t index) const
+{
+    if (index >= MAX_LEDS) {
+        index = MAX_LEDS - 1;
+    }
+    return _frame + index * 3;
+}
+
+void DDFrameBuffer::fill(uint8_t r, uint8_t g, uint8_t b)
+{
+    for (uint16_t i = 0; i < MAX_LEDS; i++) {
+        setPixel(i, r, g, b);
+    }
+}
+
+void DDFrameBuffer::clear()
+{
+    memset(_frame, 0, sizeof (_frame));
+}
+
+uint8_t *DDFrameBuffer::getData()
+{
+    return _frame;
+}
+
+uint16_t DDFrameBuffer::getSize() const
+{
+    uint16_t size = _booster.getLedCount();
+    return size > MAX_LEDS ? MAX_LEDS : size;
+}
+
+void DDFrameBuffer::invalidate()
+{
+    _valid = false;
+}
+
+bool DDFrameBuffer::isValid() const
+{
+    return _valid;
+}
+
+DDFrameCost DDFrameBuffer::estimate()
+{
+    return encode(0, getSize() - 1, false);
+}
+
+DDFrameCost DDFrameBuffer::update(uint16_t first, uint16_t last)
+{
+    if (last >= getSize()) {
+        last = getSize() - 1;
+    }
+    beginSend();
+    DDFrameCost cost = encode(first, last, true);
+    endSend();
+    return cost;
+}
+
+DDFrameCost DDFrameBuffer::flush()
+{
+    DDFrameCost cost = update(0, getSize() - 1);
+    _booster.show();
+    return cost;
+}
+
+DDFrameCost DDFrameBuffer::restore()
+{
+    uint32_t start = us_ticker_read();
+    DDFrameCost cost = {0, 0};
+
+    // without a valid state nothing was shown yet, the next flush() sends the whole frame
+    if (_valid && getSize() > 0) {
+        // _shown is not changed while it is sent, the background pointer stays valid
+        const uint8_t *fills[] = {BLACK, _shown + longestRun(_shown, getSize()) * 3};
+        uint16_t periods[] = {0, findPeriod()};
+
+        const uint8_t *bestFill = BLACK;
+        uint16_t bestPeriod = 0;
+        uint32_t bestTime = 0xFFFFFFFF;
+        for (uint8_t f = 0; f < 2; f++) {
+            for (uint8_t p = 0; p < 2; p++) {
+                if (p > 0 && periods[p] == 0) {
+                    continue;
+                }
+                uint32_t time = encodeState(fills[f], periods[p], false).getTime();
+                if (time < bestTime) {
+                    bestTime = time;
+                    bestFill = fills[f];
+                    bestPeriod = periods[p];
+                }
+            }
+        }
+        beginSend();
+        cost = encodeState(bestFill, bestPeriod, true);
+        _valid = true;
+        endSend();
+    }
+
+    _booster.show();
+    _restoreTime = us_ticker_read() - start;
+    return cost;
+}
+
+uint32_t DDFrameBuffer::getRestoreTime() const
+{
+    return _restoreTime;
+}
+
+bool DDFrameBuffer::warmStart(DDRetainedState &state, uint16_t ledCount,
+                              DDBooster::LedType ledType, DDBooster::LedColorOrder colorOrder)
+{
+    if (ledCount > MAX_LEDS) {
+        ledCount = MAX_LEDS;
+    }
+    _retained = &state;
+
+    if (state.magic == RETAINED_MAGIC && state.checksum == checksum(state) && state.ledCount == ledCount
+            && state.ledType == ledType && state.colorOrder == colorOrder) {
+        // the DD-Booster kept its configuration and shows the retained state
+        _booster.resume(ledCount);
+        memcpy(_shown, state.shown, sizeof (_shown));
+        memcpy(_frame, state.shown, sizeof (_frame));
+        _valid = true;
+        return true;
+    }
+
+    state.magic = 0;
+    state.ledCount = ledCount;
+    state.ledType = ledType;
+    state.colorOrder = colorOrder;
+    _booster.reset();
+    _booster.init(ledCount, ledType, colorOrder);
+    memset(_shown, 0, sizeof (_shown));
+    _valid = false;
+    return false;
+}
+
+void DDFrameBuffer::beginSend()
+{
+    // a restart while sending leaves the DD-Booster in an unknown state, so the retained
+    // state is only valid between transmissions
+    if (_retained) {
+        _retained->magic = 0;
+    }
+}
+
+void DDFrameBuffer::endSend()
+{
+    if (_retained && _valid) {
+        memcpy(_retained->shown, _shown, sizeof (_shown));
+        _retained->magic = RETAINED_MAGIC;
+        _retained->checksum = checksum(*_retained);
+    }
+}
+
+DDFrameCost DDFrameBuffer::encodeState(const uint8_t *fill, uint16_t period, bool send)
+{
+    DDFrameCost cost = {0, 0};
+    DDFrameCost runs;
+    uint8_t color[3];
+    bool colorValid = false;
+    uint16_t last = getSize() - 1;
+
+    if (memcmp(fill, BLACK, 3) != 0) {
+        if (send) {
+            uint8_t cmd[] = {
+                BOOSTER_SETRGB,
+                fill[0],
+                fill[1],
+                fill[2],
+                BOOSTER_SETALL
+            };
+            _booster.sendRawBytes(cmd, sizeof (cmd));
+        }
+        cost.transactions++;
+        cost.bytes += 5;
+        memcpy(color, fill, 3);
+        colorValid = true;
+    }
+
+    uint16_t first = 0;
+    if (period > 0) {
+        // send the first period and let the DD-Booster copy it as often as it fits completely
+        uint8_t count = (last + 1 - period) / period;
+        runs = encodeRuns(_shown, 0, period - 1, fill, send, color, &colorValid);
+        cost.transactions += runs.transactions + 1;
+        cost.bytes += runs.bytes + 4;
+        if (send) {
+            _booster.repeat(0, period - 1, count);
+        }
+        first = period * (count + 1);
+    }
+
+    if (first <= last) {
+        runs = encodeRuns(_shown, first, last, fill, send, color, &colorValid);
+        cost.transactions += runs.transactions;
+        cost.bytes += runs.bytes;
+    }
+    return cost;
+}
+
+uint16_t DDFrameBuffer::findPeriod() const
+{
+    uint16_t size = getSize();
+    for (uint16_t period = 1; period <= size / 2; period++) {
+        uint16_t count = (size - period) / period;
+        if (memcmp(_shown + period * 3, _shown, period * count * 3) == 0) {
+            return period;
+        }
+    }
+    return 0;
+}
+
+DDFrameCost DDFrameBuffer::encode(uint16_t first, uint16_t last, bool send)
+{
+    DDFrameCost cost = {0, 0};
+    uint8_t color[3];
+    bool colorValid = false;
+
+    if (first > last || getSize() == 0) {
+        return cost;
+    }
+
+    if (first == 0 && last == getSize() - 1) {
+        // use the color of the longest run as background candidate for setAll
+        const uint8_t *background = _frame + longestRun(_frame, last + 1) * 3;
+
+        // setRGB and setAll in one transaction, afterwards the background color is active
+        uint8_t fillColor[3];
+        bool fillColorValid = true;
+        memcpy(fillColor, background, 3);
+        DDFrameCost fillCost = encodeRuns(_frame, first, last, background, false, fillColor, &fillColorValid);
+        fillCost.transactions++;
+        fillCost.bytes += 5;
+
+        bool useFill = !_valid;
+        if (!useFill) {
+            bool diffColorValid = false;
+            DDFrameCost diffCost = encodeRuns(_frame, first, last, NULL, false, color, &diffColorValid);
+            useFill = fillCost.getTime() < diffCost.getTime();
+        }
+
+        if (useFill) {
+            if (send) {
+                uint8_t cmd[] = {
+                    BOOSTER_SETRGB,
+                    background[0],
+                    background[1],
+                    background[2],
+                    BOOSTER_SETALL
+                };
+                _booster.sendRawBytes(cmd, sizeof (cmd));
+                for (uint16_t i = 0; i < MAX_LEDS; i++) {
+                    memcpy(_shown + i * 3, background, 3);
+                }
+                _valid = true;
+            }
+            cost.transactions = 1;
+            cost.bytes = 5;
+            memcpy(color, background, 3);
+            colorValid = true;
+
+            // background pointer is part of the frame and stays valid
+            DDFrameCost runs = encodeRuns(_frame, first, last, send ? NULL : background, send, color, &colorValid);
+            cost.transactions += runs.transactions;
+            cost.bytes += runs.bytes;
+            return cost;
+        }
+    }
+
+    return encodeRuns(_frame, first, last, NULL, send, color, &colorValid);
+}
+
+DDFrameCost DDFrameBuffer::encodeRuns(const uint8_t *source, uint16_t first, uint16_t last, const uint8_t *fill, bool send, uint8_t *color, bool *colorValid)
+{
+    DDFrameCost cost = {0, 0};
+
+    uint16_t i = first;
+    while (i <= last) {
+        const uint8_t *px = source + i * 3;
+        // without fill color the state of the DD-Booster is compared, if known
+        const uint8_t *ref = fill ? fill : _shown + i * 3;
+        if ((fill || _valid) && memcmp(px, ref, 3) == 0) {
+            i++;
+            continue;
+        }
+
+        // extend the run over following LEDs with the same color, changed or not
+        uint16_t j = i;
+        while (j < last && memcmp(source + (j + 1) * 3, px, 3) == 0) {
+            j++;
+        }
+
+        bool setColor = !*colorValid || memcmp(color, px, 3) != 0;
+        cost.transactions++;
+        cost.bytes += (setColor ? 4 : 0) + (i == j ? 2 : 3);
+        if (send) {
+            sendRun(source, i, j, setColor);
+        }
+        if (setColor) {
+            memcpy(color, px, 3);
+            *colorValid = true;
+        }
+        i = j + 1;
+    }
+
+    if (send && first == 0 && last == getSize() - 1) {
+        _valid = true;
+    }
+    return cost;
+}
+
+void DDFrameBuffer::sendRun(const uint8_t *source, uint16_t start, uint16_t end, bool setColor)
+{
+    const uint8_t *px = source + start * 3;
+    uint8_t cmd[7];
+    uint8_t length = 0;
+
+    if (setColor) {
+        cmd[length++] = BOOSTER_SETRGB;
+        cmd[length++] = px[0];
+        cmd[length++] = px[1];
+        cmd[length++] = px[2];
+    }
+    if (start == end) {
+        cmd[length++] = BOOSTER_SETLED;
+        cmd[length++] = start;
+    } else {
+        cmd[length++] = BOOSTER_SETRANGE;
+        cmd[length++] = start;
+        cmd[length++] = end;
+    }
+    _booster.sendRawBytes(cmd, length);
+
+    if (source != _shown) {
+        memcpy(_shown + start * 3, px, (end - start + 1) * 3);
+    }
+}
@@ -0,0 +1,215 @@
+/*
+ * DDFrameBuffer.h - Frame buffer with difference encoding for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDFRAMEBUFFER_H
+#define DD_BOOSTER_DDFRAMEBUFFER_H
+
+#include "DDBooster.h"
+
+/**
+ * @brief Number of SPI transactions and bytes needed to send a frame.
+ */
+struct DDFrameCost {
+    uint16_t transactions;
+    uint16_t bytes;
+
+    /**
+     * Returns the estimated transfer time in microseconds: the command delay for each
+     * transaction plus the SPI time of the bytes at 12MHz.
+     */
+    uint32_t getTime() const;
+};
+
+struct DDRetainedState;
+
+/**
+ * @brief Frame buffer keeping the rendered frame and the state last sent to the DD-Booster.
+ *
+ * Effects which compute the color of every LED on the MCU render into the frame buffer.
+ * flush() compares the frame with the state already sent and transmits only the changed
+ * LEDs. Neighbour LEDs with the same color are combined to one setRange command and the
+ * color is only sent when it differs from the color of the previous command.
+ * If most of the strip has one color, it is set with setAll first and only the other
+ * LEDs are sent afterwards.
+ *
+ * Each changed range costs one SPI transaction, so sparse changes are cheap while a frame
+ * with all LEDs changed costs as much as setting every LED separately.
+ *
+ * The buffer stores RGB values for up to 256 LEDs. The DD-Booster must not be changed by
+ * other calls between two flush() calls, otherwise call invalidate() to send the whole frame.
+ */
+class DDFrameBuffer {
+public:
+
+    /**
+     * Maximal number of LEDs supported by the DD-Booster.
+     */
+    static const uint16_t MAX_LEDS = 256;
+
+    /**
+     * Creates an empty (black) frame buffer. The first flush() sends the whole frame.
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDFrameBuffer(DDBooster &booster);
+
+    /**
+     * Sets the color of one LED in the frame.
+     * @param index - Index of the LED
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * Adds a color to one LED in the frame. Each color part is limited to 255.
+     * @param index - Index of the LED
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    void addPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * Returns the RGB triplet of one LED in the frame.
+     * @param index - Index of the LED
+     */
+    const uint8_t *getPixel(uint16_t index) const;
+
+    /**
+     * Sets all LEDs of the frame to one color.
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    void fill(uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * Sets all LEDs of the frame to black.
+     */
+    void clear();
+
+    /**
+     * Returns the frame as RGB triplets for direct rendering. Holds MAX_LEDS entries.
+     */
+    uint8_t *getData();
+
+    /**
+     * Returns the number of LEDs configured in the DD-Booster.
+     */
+    uint16_t getSize() const;
+
+    /**
+     * Forgets the state sent to the DD-Booster, the next flush() sends the whole frame.
+     */
+    void invalidate();
+
+    /**
+     * Returns true if the state sent to the DD-Booster is known, i.e. update() and flush()
+     * only send the changes.
+     */
+    bool isValid() const;
+
+    /**
+     * Returns the cost of sending the changes of the current frame, without sending them.
+     * The SHOW command is not included.
+     */
+    DDFrameCost estimate();
+
+    /**
+     * Sends the changes of a part of the frame without calling show().
+     * @param first - Index of the first LED to check
+     * @param last - Index of the last LED to check
+     * @return cost of the sent commands
+     */
+    DDFrameCost update(uint16_t first, uint16_t last);
+
+    /**
+     * Sends the changes of the whole frame and calls show().
+     * @return cost of the sent commands, without the SHOW command
+     */
+    DDFrameCost flush();
+
+    /**
+     * Sends the last shown state again and calls show(), e.g. after the DD-Booster was reset
+     * by a watchdog. Call it after DDBooster::reset() and DDBooster::init(). The frame being
+     * rendered is not changed. Nothing is sent if no frame was sent since the last invalidate().
+     *
+     * The DD-Booster is black after init(), so only LEDs differing from black or from the most
+     * frequent color (set with setAll) are sent. If the state repeats with a period, only the
+     * first period is sent and copied with the repeat command. The cheapest of these
+     * encodings is used.
+     * @return cost of the sent commands, without the SHOW command
+     */
+    DDFrameCost restore();
+
+    /**
+     * Returns the duration of the last restore() call in microseconds, including show().
+     */
+    uint32_t getRestoreTime() const;
+
+    /**
+     * Initializes the DD-Booster, or continues with it after a restart of the MCU only.
+     *
+     * The configuration and the state sent to the DD-Booster are kept in a DDRetainedState,
+     * which is updated after each transmission. If it is still valid after the restart and was
+     * written with the same configuration, the DD-Booster still shows this state: reset() and
+     * init() are skipped and the next flush() only sends the changes. Otherwise the
+     * DD-Booster is reset and initialized as usual.
+     *
+     * The state must be placed in RAM which is not cleared by the startup code, see
+     * DD_RETAINED. It is lost on power loss, which resets the DD-Booster as well.
+     * @param state - Retained state, must stay valid while the frame buffer is used
+     * @param ledCount - Number of used LEDs
+     * @param ledType - Type of LEDs used. RGB is default
+     * @param colorOrder - LED color order. GRB is default
+     * @return true if the DD-Booster was continued without reset and init
+     */
+    bool warmStart(DDRetainedState &state, uint16_t ledCount,
+                   DDBooster::LedType ledType = DDBooster::LED_RGB,
+                   DDBooster::LedColorOrder colorOrder = DDBooster::ORDER_GRB);
+
+private:
+    void beginSend();
+    void endSend();
+    DDFrameCost encode(uint16_t first, uint16_t last, bool send);
+    DDFrameCost encodeRuns(const uint8_t *source, uint16_t first, uint16_t last, const uint8_t *fill, bool send, uint8_t *color, bool *colorValid);
+    DDFrameCost encodeState(const uint8_t *fill, uint16_t period, bool send);
+    uint16_t findPeriod() const;
+    void sendRun(const uint8_t *source, uint16_t start, uint16_t end, bool setColor);
+
+    DDBooster &_booster;
+    bool _valid;
+    uint8_t _frame[MAX_LEDS * 3];
+    uint8_t _shown[MAX_LEDS * 3];
+    uint32_t _restoreTime;
+    DDRetainedState *_retained;
+};
+
+/**
+ * Places a variable in RAM which is not initialized at startup. The linker script of the
+ * target must provide a .noinit section (NOLOAD) for it.
+ */
+#ifndef DD_RETAINED
+#define DD_RETAINED __attribute__((section(".noinit")))
+#endif
+
+/**
+ * @brief Configuration and last sent state of a DD-Booster kept over MCU restarts.
+ *
+ * Declare it with DD_RETAINED and pass it to DDFrameBuffer::warmStart(). The content is
+ * managed by the frame buffer.
+ */
+struct DDRetainedState {
+    uint32_t magic;
+    uint16_t ledCount;
+    uint8_t ledType;
+    uint8_t colorOrder;
+    uint8_t shown[DDFrameBuffer::MAX_LEDS * 3];
+    uint32_t checksum;
+};
+
+#endif //DD_BOOSTER_DDFRAMEBUFFER_H
@@ -0,0 +1,143 @@
+/*
+ * DDInterpolator.cpp - Frame rate upconversion for sparse input frames
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDInterpolator.h"
+#include "DDBoosterProtocol.h"
+
+DDInterpolator::DDInterpolator(DDFrameBuffer &frame)
+    : _frame(frame)
+    , _enabled(true)
+    , _active(false)
+    , _started(false)
+    , _budget(80)
+    , _lastProgress(0)
+    , _sentProgress(0)
+    , _interval(0)
+    , _cost(0)
+    , _nextSkip(0)
+    , _interpolated(0)
+    , _skipped(0)
+{
+}
+
+void DDInterpolator::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+void DDInterpolator::setBudget(uint8_t percent)
+{
+    if (percent < 1) {
+        percent = 1;
+    } else if (percent > 100) {
+        percent = 100;
+    }
+    _budget = percent;
+}
+
+void DDInterpolator::push(const uint8_t *frame)
+{
+    uint16_t size = _frame.getSize();
+    bool first = !_started;
+
+    if (!first) {
+        uint32_t interval = _timer.read_us();
+        // smoothed source interval, the first measurement is taken as it is
+        _interval = _interval ? (_interval * 3 + interval) / 4 : interval;
+    }
+    _timer.reset();
+    _timer.start();
+    _started = true;
+
+    if (!_enabled || first) {
+        memcpy(_frame.getData(), frame, size * 3);
+        memcpy(_to, frame, size * 3);
+        _frame.flush();
+        _active = false;
+        return;
+    }
+
+    // continue from what is shown now, the previous target might not have been reached.
+    // The frame buffer always holds the last sent frame
+    memcpy(_from, _frame.getData(), size * 3);
+    memcpy(_to, frame, size * 3);
+
+    // an intermediate frame changes at most the LEDs of the whole step
+    memcpy(_frame.getData(), _to, size * 3);
+    _cost = frameTime(_frame.estimate());
+    memcpy(_frame.getData(), _from, size * 3);
+
+    _nextSkip = 0;
+    _lastProgress = 0;
+    _sentProgress = 0;
+    _active = true;
+}
+
+bool DDInterpolator::update()
+{
+    if (!_active || _interval == 0) {
+        return false;
+    }
+
+    uint16_t size = _frame.getSize();
+    uint32_t elapsed = _timer.read_us();
+    uint16_t t = elapsed >= _interval ? 256 : elapsed * 256 / _interval;
+
+    if (t >= 256) {
+        memcpy(_frame.getData(), _to, size * 3);
+        _frame.flush();
+        _active = false;
+        return true;
+    }
+    if (t == _lastProgress) {
+        return false;
+    }
+    _lastProgress = t;
+
+    // send only if the frame fits into the usable rest of the interval. The cost of the
+    // previous difference is taken, so nothing is blended for a frame which is not sent
+    uint32_t budget = _interval * _budget / 100;
+    uint32_t remaining = budget > elapsed ? budget - elapsed : 0;
+    if (_cost > remaining) {
+        // a frame could have been sent in each frame time, count the missed ones only
+        if (elapsed >= _nextSkip) {
+            _nextSkip = elapsed + _cost;
+            _skipped++;
+        }
+        return false;
+    }
+
+    blend(t);
+    _cost = frameTime(_frame.flush());
+    _sentProgress = t;
+    _interpolated++;
+    return true;
+}
+
+uint32_t DDInterpolator::frameTime(const DDFrameCost &cost) const
+{
+    return cost.getTime() + BOOSTER_CMD_DELAY + BOOSTER_LED_DELAY * _frame.getSize();
+}
+
+void DDInterpolator::blend(uint16_t t)
+{
+    uint8_t *data = _frame.getData();
+    uint16_t size = _frame.getSize();
+    for (uint16_t k = 0; k < size * 3; k++) {
+        data[k] = _from[k] + ((_to[k] - _from[k]) * t >> 8);
+    }
+}
+
+uint32_t DDInterpolator::getInterpolatedCount() const
+{
+    return _interpolated;
+}
+
+uint32_t DDInterpolator::getSkippedCount() const
+{
+    return _skipped;
+}
@@ -0,0 +1,88 @@
+/*
+ * DDInterpolator.h - Frame rate upconversion for sparse input frames
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDINTERPOLATOR_H
+#define DD_BOOSTER_DDINTERPOLATOR_H
+
+#include "DDFrameBuffer.h"
+
+/**
+ * @brief Inserts interpolated frames between frames received at a low rate.
+ *
+ * Content sources often deliver 10 - 20 frames per second. If the bus has time left until
+ * the next source frame arrives, intermediate frames blending the previous and the new
+ * source frame are sent. The interval between source frames is measured. The cost of an
+ * intermediate frame is taken from the previous one, the first one is estimated with
+ * DDFrameBuffer::estimate() for the whole step. An intermediate frame is only sent if it
+ * fits into the remaining time of the interval, otherwise it is skipped without blending.
+ *
+ * Blending towards the latest source frame delays the output by one source interval.
+ * Without interpolation (disabled or the first frame) new frames are sent immediately.
+ */
+class DDInterpolator {
+public:
+
+    /**
+     * @param frame - Frame buffer the frames are sent with
+     */
+    DDInterpolator(DDFrameBuffer &frame);
+
+    /**
+     * Enables or disables the interpolation. Enabled by default.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * Sets the part of the source interval which can be used for intermediate frames.
+     * @param percent - Usable part of the interval (1 - 100), 80 is default
+     */
+    void setBudget(uint8_t percent);
+
+    /**
+     * Passes a new source frame.
+     * @param frame - RGB triplets, one for each LED of the frame buffer. It is copied
+     */
+    void push(const uint8_t *frame);
+
+    /**
+     * Sends an intermediate frame if the bus has enough time left. Call it as often as possible.
+     * @return true if a frame was sent
+     */
+    bool update();
+
+    /**
+     * Returns the number of intermediate frames sent.
+     */
+    uint32_t getInterpolatedCount() const;
+
+    /**
+     * Returns the number of intermediate frames skipped because the bus had no time left,
+     * one for each frame time without a sent frame.
+     */
+    uint32_t getSkippedCount() const;
+
+private:
+    uint32_t frameTime(const DDFrameCost &cost) const;
+    void blend(uint16_t t);
+
+    DDFrameBuffer &_frame;
+    bool _enabled;
+    bool _active;
+    bool _started;
+    uint8_t _budget;
+    uint16_t _lastProgress;
+    uint16_t _sentProgress;
+    uint32_t _interval;
+    uint32_t _cost;
+    uint32_t _nextSkip;
+    uint32_t _interpolated;
+    uint32_t _skipped;
+    Timer _timer;
+    uint8_t _from[DDFrameBuffer::MAX_LEDS * 3];
+    uint8_t _to[DDFrameBuffer::MAX_LEDS * 3];
+};
+
+#endif //DD_BOOSTER_DDINTERPOLATOR_H
@@ -0,0 +1,143 @@
+/*
+ * DDLatencyModel.cpp - Estimates when each LED changes after an API call
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDLatencyModel.h"
+#include "DDBoosterProtocol.h"
+
+DDLatencyModel::DDLatencyModel(DDBooster &booster)
+    : _booster(booster)
+    , _monitor(-1)
+    , _called(false)
+    , _callTime(0)
+    , _inFrame(false)
+    , _firstCommand(0)
+    , _frames(0)
+{
+    _emulator.reset(booster.getLedCount());
+    memset(_previous, 0, sizeof (_previous));
+    memset(_changed, 0, sizeof (_changed));
+    memset(_maxLatency, 0, sizeof (_maxLatency));
+    memset(&_frame, 0, sizeof (_frame));
+    _monitor = _booster.attachMonitor(callback(this, &DDLatencyModel::onTransaction));
+}
+
+DDLatencyModel::~DDLatencyModel()
+{
+    _booster.detachMonitor(_monitor);
+}
+
+void DDLatencyModel::markCall()
+{
+    core_util_critical_section_enter();
+    if (!_called && !_inFrame) {
+        _called = true;
+        _callTime = us_ticker_read();
+    }
+    core_util_critical_section_exit();
+}
+
+void DDLatencyModel::onTransaction(const uint8_t *data, uint8_t length)
+{
+    // called after the transfer, 8 bits take 2/3 us at 12MHz
+    uint32_t now = us_ticker_read();
+    uint32_t start = now - length * 2 / 3;
+
+    core_util_critical_section_enter();
+    if (!_inFrame) {
+        _inFrame = true;
+        if (!_called) {
+            _callTime = start;
+        } else if ((int32_t) (start - _callTime) < 0) {
+            // the estimated transfer time reaches back before the call
+            start = _callTime;
+        }
+        _firstCommand = start;
+    }
+    core_util_critical_section_exit();
+
+    _emulator.process(data, length);
+
+    if (!DDBooster::containsShow(data, length)) {
+        return;
+    }
+
+    _frame.number = _frames++;
+    _frame.callTime = _callTime;
+    _frame.queueTime = _firstCommand - _callTime;
+    _frame.sendTime = now - _firstCommand;
+    _frame.showTime = now - _callTime;
+    _frame.ledCount = _emulator.getLedCount();
+    _frame.changed = 0;
+
+    for (uint16_t i = 0; i < _frame.ledCount; i++) {
+        const uint8_t *shown = _emulator.getShown(i);
+        uint8_t *previous = _previous + i * 3;
+        if (memcmp(shown, previous, 3) == 0) {
+            _changed[i >> 3] &= ~(1 << (i & 7));
+            continue;
+        }
+        memcpy(previous, shown, 3);
+        _changed[i >> 3] |= 1 << (i & 7);
+        _frame.changed++;
+
+        uint32_t latency = getLatency(i);
+        if (latency > _maxLatency[i]) {
+            _maxLatency[i] = latency;
+        }
+    }
+    for (uint16_t i = _frame.ledCount; i < MAX_LEDS; i++) {
+        _changed[i >> 3] &= ~(1 << (i & 7));
+    }
+
+    core_util_critical_section_enter();
+    _inFrame = false;
+    _called = false;
+    core_util_critical_section_exit();
+}
+
+const DDLatencyModel::Frame &DDLatencyModel::getFrame() const
+{
+    return _frame;
+}
+
+bool DDLatencyModel::isChanged(uint16_t index) const
+{
+    return index < MAX_LEDS && (_changed[index >> 3] & (1 << (index & 7)));
+}
+
+uint32_t DDLatencyModel::getLatency(uint16_t index) const
+{
+    if (!isChanged(index)) {
+        return 0;
+    }
+    return _frame.showTime + (index + 1) * BOOSTER_LED_DELAY;
+}
+
+uint32_t DDLatencyModel::getMaxLatency(uint16_t index) const
+{
+    return index < MAX_LEDS ? _maxLatency[index] : 0;
+}
+
+void DDLatencyModel::resetStatistics()
+{
+    memset(_maxLatency, 0, sizeof (_maxLatency));
+}
+
+void DDLatencyModel::writeTrace(FILE *file) const
+{
+    fprintf(file, "{\"frame\":%lu,\"call_us\":%lu,\"queue_us\":%lu,\"send_us\":%lu,\"show_us\":%lu,\"leds\":%u,\"changed\":%u,\"latency_us\":[",
+            (unsigned long) _frame.number, (unsigned long) _frame.callTime, (unsigned long) _frame.queueTime,
+            (unsigned long) _frame.sendTime, (unsigned long) _frame.showTime, _frame.ledCount, _frame.changed);
+    bool first = true;
+    for (uint16_t i = 0; i < _frame.ledCount; i++) {
+        if (isChanged(i)) {
+            fprintf(file, "%s[%u,%lu]", first ? "" : ",", i, (unsigned long) getLatency(i));
+            first = false;
+        }
+    }
+    fprintf(file, "]}\n");
+}
@@ -0,0 +1,117 @@
+/*
+ * DDLatencyModel.h - Estimates when each LED changes after an API call
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDLATENCYMODEL_H
+#define DD_BOOSTER_DDLATENCYMODEL_H
+
+#include "DDBoosterEmulator.h"
+
+/**
+ * @brief Per LED latency from the API call of a frame until the LED shows its new color.
+ *
+ * The model is attached to a DDBooster with DDBooster::attachMonitor() and detached when it
+ * is destroyed, other monitors of the booster are not affected. The application calls
+ * markCall() when it starts a frame, e.g. before DDFrameBuffer::flush() or before
+ * submitting the commands to another thread.
+ * A frame ends with its SHOW command, the latency of each LED is split into:
+ *
+ * - queueing: from markCall() until the first command of the frame is sent
+ * - sending: from the first command until the end of the SHOW transaction
+ * - propagation: the LEDs are updated one after another, LED i gets its data
+ *   (i + 1) * BOOSTER_LED_DELAY after the SHOW
+ *
+ * The commands are executed by an emulator to find the LEDs changed by the frame, only
+ * those get a latency. Without markCall() the frame starts with its first command.
+ */
+class DDLatencyModel {
+public:
+
+    /**
+     * Maximal number of LEDs supported by the DD-Booster.
+     */
+    static const uint16_t MAX_LEDS = DDBoosterEmulator::MAX_LEDS;
+
+    /**
+     * Timing of one frame in microseconds, relative to the call.
+     */
+    struct Frame {
+        uint32_t number;
+        uint32_t callTime;
+        uint32_t queueTime;
+        uint32_t sendTime;
+        uint32_t showTime;
+        uint16_t ledCount;
+        uint16_t changed;
+    };
+
+    /**
+     * Attaches the model to a booster. The LEDs are assumed black like after init().
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDLatencyModel(DDBooster &booster);
+
+    ~DDLatencyModel();
+
+    /**
+     * Marks the API call starting the next frame. Calls after the first command of the
+     * frame was sent are ignored.
+     */
+    void markCall();
+
+    /**
+     * Returns the timing of the last completed frame.
+     */
+    const Frame &getFrame() const;
+
+    /**
+     * Returns true if the last frame changed the LED.
+     * @param index - Index of the LED
+     */
+    bool isChanged(uint16_t index) const;
+
+    /**
+     * Returns the time from the call of the last frame until the LED was updated.
+     * @param index - Index of the LED
+     * @return latency in microseconds, 0 if the LED was not changed by the last frame
+     */
+    uint32_t getLatency(uint16_t index) const;
+
+    /**
+     * Returns the highest latency of the LED since the last resetStatistics() call.
+     * @param index - Index of the LED
+     */
+    uint32_t getMaxLatency(uint16_t index) const;
+
+    /**
+     * Resets the highest latencies.
+     */
+    void resetStatistics();
+
+    /**
+     * Writes the last frame as one JSON line: the timing and [index, latency] of each
+     * changed LED.
+     * @param file - Output, e.g. stdout
+     */
+    void writeTrace(FILE *file) const;
+
+private:
+    void onTransaction(const uint8_t *data, uint8_t length);
+
+    DDBooster &_booster;
+    int8_t _monitor;
+    DDBoosterEmulator _emulator;
+    uint8_t _previous[MAX_LEDS * 3];
+    uint8_t _changed[MAX_LEDS / 8];
+    uint32_t _maxLatency[MAX_LEDS];
+    Frame _frame;
+    volatile bool _called;
+    volatile uint32_t _callTime;
+    bool _inFrame;
+    uint32_t _firstCommand;
+    uint32_t _frames;
+};
+
+#endif //DD_BOOSTER_DDLATENCYMODEL_H
@@ -0,0 +1,224 @@
+/*
+ * DDMarquee.cpp - Scrolling text for LED strips and matrices driven by the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDMarquee.h"
+
+// one column in units of the speed accumulator (1/256 column * ms)
+#define MARQUEE_COLUMN_UNIT  (256 * 1000)
+
+static uint8_t countBits(uint8_t bits)
+{
+    uint8_t count = 0;
+    while (bits) {
+        count += bits & 1;
+        bits >>= 1;
+    }
+    return count;
+}
+
+DDMarquee::DDMarquee(DDBooster &booster, const DDFont &font, Layout layout, uint8_t width, uint8_t height)
+    : _booster(booster)
+    , _font(font)
+    , _layout(layout)
+    , _width(width)
+    , _height(height)
+    , _text("")
+    , _textColumns(0)
+    , _position(0)
+    , _speed(0)
+    , _remainder(0)
+{
+    if (_layout == LAYOUT_STRIP) {
+        _height = 1;
+    }
+    _color[0] = _color[1] = _color[2] = 255;
+    _background[0] = _background[1] = _background[2] = 0;
+}
+
+void DDMarquee::setText(const char *text)
+{
+    if (_layout == LAYOUT_STRIP) {
+        // booster might have been initialized after the marquee was created
+        _width = _booster.getLedCount();
+    }
+    _text = text;
+    _textColumns = strlen(text) * (_font.getWidth() + 1);
+    // start with an empty display, the text enters from the right
+    _position = _textColumns;
+    _remainder = 0;
+}
+
+void DDMarquee::setColor(uint8_t r, uint8_t g, uint8_t b)
+{
+    _color[0] = r;
+    _color[1] = g;
+    _color[2] = b;
+}
+
+void DDMarquee::setBackground(uint8_t r, uint8_t g, uint8_t b)
+{
+    _background[0] = r;
+    _background[1] = g;
+    _background[2] = b;
+}
+
+void DDMarquee::setSpeed(int32_t speed)
+{
+    // the text only scrolls to the left, a negative speed would let the remainder run down
+    // until it overflows
+    _speed = speed < 0 ? 0 : speed;
+}
+
+bool DDMarquee::update(uint32_t elapsedMs)
+{
+    uint8_t stepSize = _layout == LAYOUT_COLUMNS_SERPENTINE ? 2 : 1;
+
+    _remainder += _speed * (int32_t) elapsedMs;
+    if (_remainder < stepSize * MARQUEE_COLUMN_UNIT) {
+        return false;
+    }
+    while (_remainder >= stepSize * MARQUEE_COLUMN_UNIT) {
+        _remainder -= stepSize * MARQUEE_COLUMN_UNIT;
+        step();
+    }
+    _booster.show();
+    return true;
+}
+
+void DDMarquee::step()
+{
+    if (_width == 0 || _height == 0) {
+        return;
+    }
+
+    uint8_t rows = _font.getHeight() < _height ? _font.getHeight() : _height;
+    uint8_t x = _width - 1;
+
+    switch (_layout) {
+    case LAYOUT_STRIP:
+        _position++;
+        _booster.shiftDown(0, x, 1);
+        drawColumn(x, textColumn(_position + x));
+        break;
+
+    case LAYOUT_ROWS_SERPENTINE:
+        _position++;
+        for (uint8_t y = 0; y < rows; y++) {
+            uint8_t start = y * _width;
+            uint8_t end = start + x;
+            if (y & 1) {
+                // odd rows run from right to left
+                _booster.shiftUp(start, end, 1);
+            } else {
+                _booster.shiftDown(start, end, 1);
+            }
+        }
+        drawColumn(x, textColumn(_position + x));
+        break;
+
+    case LAYOUT_COLUMNS_SERPENTINE:
+        _position += 2;
+        if (_width < 3) {
+            redraw();
+            break;
+        }
+        _booster.shiftDown(0, _width * _height - 1, 2 * _height);
+        drawColumn(x - 1, textColumn(_position + x - 1));
+        drawColumn(x, textColumn(_position + x));
+        break;
+    }
+
+    uint32_t period = _textColumns + _width;
+    _position %= period;
+}
+
+void DDMarquee::redraw()
+{
+    if (_width == 0 || _height == 0) {
+        return;
+    }
+
+    // fill the background with one command and draw only the columns with content
+    _booster.setRange(0, _width * _height - 1, _background[0], _background[1], _background[2]);
+    for (uint16_t x = 0; x < _width; x++) {
+        uint8_t bits = textColumn(_position + x);
+        if (bits) {
+            drawColumn(x, bits);
+        }
+    }
+}
+
+uint8_t DDMarquee::textColumn(uint32_t column) const
+{
+    uint8_t glyphWidth = _font.getWidth() + 1;
+
+    column %= _textColumns + _width;
+    if (column >= _textColumns) {
+        return 0;
+    }
+    uint8_t x = column % glyphWidth;
+    if (x == glyphWidth - 1) {
+        // spacing between two glyphs
+        return 0;
+    }
+    return _font.getColumn(_text[column / glyphWidth], x);
+}
+
+void DDMarquee::drawColumn(uint8_t x, uint8_t bits)
+{
+    uint8_t fontHeight = _font.getHeight();
+
+    if (_layout == LAYOUT_STRIP) {
+        uint8_t lit = countBits(bits);
+        uint8_t color[3];
+        for (int i = 0; i < 3; i++) {
+            color[i] = _background[i] + (_color[i] - _background[i]) * lit / fontHeight;
+        }
+        _booster.setLED(x, color[0], color[1], color[2]);
+        return;
+    }
+
+    if (_layout == LAYOUT_ROWS_SERPENTINE) {
+        uint8_t rows = fontHeight < _height ? fontHeight : _height;
+        for (uint8_t y = 0; y < rows; y++) {
+            const uint8_t *color = (bits >> y) & 1 ? _color : _background;
+            _booster.setLED(ledIndex(x, y), color[0], color[1], color[2]);
+        }
+        return;
+    }
+
+    // the LEDs of a column are consecutive, so equal neighbours are sent as range
+    uint8_t first = x * _height;
+    uint8_t start = 0;
+    while (start < _height) {
+        uint8_t y = ledIndex(x, start) - first;
+        bool lit = y < fontHeight && ((bits >> y) & 1);
+        uint8_t end = start;
+        while (end + 1 < _height) {
+            uint8_t next = ledIndex(x, end + 1) - first;
+            if ((next < fontHeight && ((bits >> next) & 1)) != lit) {
+                break;
+            }
+            end++;
+        }
+        const uint8_t *color = lit ? _color : _background;
+        if (start == end) {
+            _booster.setLED(first + start, color[0], color[1], color[2]);
+        } else {
+            _booster.setRange(first + start, first + end, color[0], color[1], color[2]);
+        }
+        start = end + 1;
+    }
+}
+
+uint16_t DDMarquee::ledIndex(uint8_t x, uint8_t y) const
+{
+    if (_layout == LAYOUT_COLUMNS_SERPENTINE) {
+        return x * _height + ((x & 1) ? _height - 1 - y : y);
+    }
+    return y * _width + ((y & 1) ? _width - 1 - x : x);
+}
@@ -0,0 +1,120 @@
+/*
+ * DDMarquee.h - Scrolling text for LED strips and matrices driven by the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDMARQUEE_H
+#define DD_BOOSTER_DDMARQUEE_H
+
+#include "DDBooster.h"
+#include "DDFont.h"
+
+/**
+ * @brief Scrolls a text from right to left using the shift commands of the DD-Booster.
+ *
+ * The text is never rendered as a whole. Each step the current content is shifted by the
+ * DD-Booster itself and only the incoming column is read from the font and sent.
+ *
+ * Supported layouts:
+ * - LAYOUT_STRIP: single LED strip. Each text column becomes one LED, its brightness is
+ *   the number of lit pixels in the column.
+ * - LAYOUT_ROWS_SERPENTINE: matrix with rows, row 0 is the top row starting at LED 0 going
+ *   right, the next row goes back to the left. Each row is shifted separately, rows below
+ *   the font height are left untouched.
+ * - LAYOUT_COLUMNS_SERPENTINE: matrix with columns, column 0 is the left column starting at
+ *   LED 0 going down, the next column goes back up. Shifting by one column would flip the
+ *   column direction, so the whole matrix is shifted by two columns per step.
+ *
+ * The text is followed by a gap of the display width before it repeats, so it scrolls out
+ * completely before appearing again.
+ */
+class DDMarquee {
+public:
+
+    /**
+     * LED arrangement of the display.
+     */
+    enum Layout {
+        LAYOUT_STRIP,
+        LAYOUT_ROWS_SERPENTINE,
+        LAYOUT_COLUMNS_SERPENTINE
+    };
+
+    /**
+     * Creates a marquee. Call setText() and redraw() before the first update.
+     * @param booster - Initialized DD-Booster instance
+     * @param font - Font used to render the text
+     * @param layout - LED arrangement, LAYOUT_STRIP is default
+     * @param width - Number of matrix columns. Ignored for LAYOUT_STRIP
+     * @param height - Number of matrix rows. Ignored for LAYOUT_STRIP
+     */
+    DDMarquee(DDBooster &booster, const DDFont &font, Layout layout = LAYOUT_STRIP, uint8_t width = 0, uint8_t height = 0);
+
+    /**
+     * Sets the text and restarts scrolling from the beginning. Does not redraw.
+     * @param text - Zero terminated text. Must stay valid while the marquee is used
+     */
+    void setText(const char *text);
+
+    /**
+     * Sets the text color.
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    void setColor(uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * Sets the background color. Black is default.
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     */
+    void setBackground(uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * Sets the scroll speed used by update().
+     * @param speed - Speed in 1/256 column per second. Text scrolls to the left only,
+     *                negative values are taken as 0 and stop the marquee
+     */
+    void setSpeed(int32_t speed);
+
+    /**
+     * Scrolls according to the speed and the elapsed time. Calls show() if the text moved.
+     * @param elapsedMs - Time elapsed since the last call in milliseconds
+     * @return true if the text moved
+     */
+    bool update(uint32_t elapsedMs);
+
+    /**
+     * Scrolls one step: one column, two columns for LAYOUT_COLUMNS_SERPENTINE.
+     * Does not call show().
+     */
+    void step();
+
+    /**
+     * Sends the complete visible text area. Does not call show().
+     */
+    void redraw();
+
+private:
+    uint8_t textColumn(uint32_t column) const;
+    void drawColumn(uint8_t x, uint8_t bits);
+    uint16_t ledIndex(uint8_t x, uint8_t y) const;
+
+    DDBooster &_booster;
+    const DDFont &_font;
+    Layout _layout;
+    uint16_t _width;
+    uint8_t _height;
+    const char *_text;
+    uint32_t _textColumns;
+    uint32_t _position;
+    uint8_t _color[3];
+    uint8_t _background[3];
+    int32_t _speed;
+    int32_t _remainder;
+};
+
+#endif //DD_BOOSTER_DDMARQUEE_H
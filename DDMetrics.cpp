@@ -0,0 +1,367 @@
+/*
+ * DDMetrics.cpp - Prometheus metrics of Digi-Dot-Boosters served over HTTP
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_NSAPI_PRESENT && MBED_CONF_RTOS_PRESENT
+
+#include <stdarg.h>
+#include "DDMetrics.h"
+#include "DDBoosterProtocol.h"
+
+// timeout for sending a response, the main loop is blocked meanwhile
+#define SEND_TIMEOUT_MS   1000
+
+static const struct {
+    uint8_t code;
+    const char *name;
+} OPCODES[] = {
+    {BOOSTER_SETRGB, "setrgb"},
+    {BOOSTER_SETRGBW, "setrgbw"},
+    {BOOSTER_SETHSV, "sethsv"},
+    {BOOSTER_SETLED, "setled"},
+    {BOOSTER_SETALL, "setall"},
+    {BOOSTER_SETRANGE, "setrange"},
+    {BOOSTER_SETRAINBOW, "setrainbow"},
+    {BOOSTER_GRADIENT, "gradient"},
+    {BOOSTER_INIT, "init"},
+    {BOOSTER_SHOW, "show"},
+    {BOOSTER_SHIFTUP, "shiftup"},
+    {BOOSTER_SHIFTDOWN, "shiftdown"},
+    {BOOSTER_COPYLED, "copyled"},
+    {BOOSTER_REPEAT, "repeat"},
+    {BOOSTER_RGBORDER, "rgborder"}
+};
+
+// upper bounds of the frame time buckets in microseconds, the last one is +Inf
+static const uint32_t BUCKET_BOUNDS[] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+static const char *BUCKET_LABELS[] = {"0.001", "0.002", "0.005", "0.01", "0.02", "0.05", "0.1", "+Inf"};
+
+/**
+ * Formats microseconds as seconds without floating point.
+ */
+static const char *seconds(char *buffer, uint64_t us)
+{
+    sprintf(buffer, "%lu.%06lu", (unsigned long) (us / 1000000), (unsigned long) (us % 1000000));
+    return buffer;
+}
+
+DDMetrics::DDMetrics()
+    : _boosterCount(0)
+    , _controller(NULL)
+    , _client(NULL)
+    , _signaled(false)
+    , _requestLength(0)
+    , _file(NULL)
+    , _outputLength(0)
+{
+    memset(_boosters, 0, sizeof (_boosters));
+}
+
+DDMetrics::~DDMetrics()
+{
+    for (uint8_t i = 0; i < _boosterCount; i++) {
+        _boosters[i].booster->detachMonitor(_boosters[i].monitor);
+    }
+    closeClient();
+    _server.close();
+}
+
+int8_t DDMetrics::addBooster(DDBooster &booster, const char *name, int8_t strip)
+{
+    if (_boosterCount >= MAX_BOOSTERS) {
+        return -1;
+    }
+    Booster &b = _boosters[_boosterCount];
+    b.booster = &booster;
+    b.name = name;
+    b.strip = strip;
+    b.monitor = booster.attachMonitor(callback(&b, &Booster::onTransaction));
+    if (b.monitor < 0) {
+        memset(&b, 0, sizeof (b));
+        return -1;
+    }
+    return _boosterCount++;
+}
+
+void DDMetrics::attachController(DDBusController &controller)
+{
+    _controller = &controller;
+}
+
+void DDMetrics::recordEncodeTime(uint8_t booster, uint32_t us)
+{
+    if (booster >= _boosterCount) {
+        return;
+    }
+    _boosters[booster].encodeTime += us;
+    _boosters[booster].encodeCount++;
+}
+
+void DDMetrics::Booster::onTransaction(const uint8_t *data, uint8_t length)
+{
+    uint32_t now = us_ticker_read();
+    transactions++;
+    if (!inFrame) {
+        inFrame = true;
+        frameStart = now;
+    }
+
+    uint8_t i = 0;
+    while (i < length) {
+        uint8_t remaining = length - i;
+        uint8_t size = DDBooster::getCommandSize(data[i]);
+        if (size == 0 || size > remaining) {
+            // without a known size the rest of the transaction belongs to this command
+            size = remaining;
+        }
+
+        uint8_t op = 0;
+        while (op < NUM_OPCODES && OPCODES[op].code != data[i]) {
+            op++;
+        }
+        commands[op]++;
+        bytes[op] += size;
+
+        if (data[i] == BOOSTER_SHOW) {
+            uint32_t latch = BOOSTER_LED_DELAY * booster->getLedCount();
+            uint32_t frame = now - frameStart + latch;
+            latchTime += latch;
+            frameTime += frame;
+            uint8_t bucket = 0;
+            while (bucket < NUM_BUCKETS - 1 && frame > BUCKET_BOUNDS[bucket]) {
+                bucket++;
+            }
+            buckets[bucket]++;
+            frames++;
+            inFrame = false;
+        }
+        i += size;
+    }
+}
+
+nsapi_error_t DDMetrics::open(NetworkInterface *network, uint16_t port)
+{
+    nsapi_error_t result = _server.open(network);
+    if (result != NSAPI_ERROR_OK) {
+        return result;
+    }
+    result = _server.bind(port);
+    if (result == NSAPI_ERROR_OK) {
+        result = _server.listen(1);
+    }
+    if (result != NSAPI_ERROR_OK) {
+        _server.close();
+        return result;
+    }
+    _server.set_blocking(false);
+    _server.sigio(callback(this, &DDMetrics::onSignal));
+    _signaled = true;
+    return NSAPI_ERROR_OK;
+}
+
+void DDMetrics::onSignal()
+{
+    // called from the network stack context, the work is done in poll()
+    _signaled = true;
+}
+
+void DDMetrics::poll()
+{
+    if (!_signaled) {
+        return;
+    }
+    _signaled = false;
+    if (!_client) {
+        accept();
+    }
+    if (_client) {
+        read();
+    }
+}
+
+void DDMetrics::accept()
+{
+    nsapi_error_t error;
+    _client = _server.accept(&error);
+    if (_client) {
+        _requestLength = 0;
+        _client->set_blocking(false);
+        _client->sigio(callback(this, &DDMetrics::onSignal));
+    }
+}
+
+void DDMetrics::read()
+{
+    while (_client) {
+        nsapi_size_or_error_t length = _client->recv(_request + _requestLength, sizeof (_request) - 1 - _requestLength);
+        if (length == NSAPI_ERROR_WOULD_BLOCK) {
+            break;
+        }
+        if (length <= 0) {
+            closeClient();
+            break;
+        }
+        _requestLength += length;
+        _request[_requestLength] = 0;
+
+        // only the request line matters, the rest of a long header is not read
+        if (strstr(_request, "\r\n\r\n") || _requestLength == sizeof (_request) - 1) {
+            respond();
+            closeClient();
+            // the next client may be waiting already
+            _signaled = true;
+        }
+    }
+}
+
+void DDMetrics::respond()
+{
+    _client->set_timeout(SEND_TIMEOUT_MS);
+    _outputLength = 0;
+
+    if (strncmp(_request, "GET /metrics", 12) != 0 || (_request[12] != ' ' && _request[12] != '?')) {
+        print("HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nNot Found\n");
+        flushOutput();
+        return;
+    }
+    print("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n");
+    writeMetrics();
+    flushOutput();
+}
+
+void DDMetrics::closeClient()
+{
+    if (_client) {
+        // closing an accepted socket also releases it
+        _client->close();
+        _client = NULL;
+    }
+}
+
+void DDMetrics::write(FILE *file)
+{
+    _file = file;
+    _outputLength = 0;
+    writeMetrics();
+    flushOutput();
+    _file = NULL;
+}
+
+void DDMetrics::writeMetrics()
+{
+    char text[24];
+
+    print("# HELP dd_booster_commands_total Commands sent per opcode.\n# TYPE dd_booster_commands_total counter\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        for (uint8_t op = 0; op <= NUM_OPCODES; op++) {
+            print("dd_booster_commands_total{booster=\"%s\",opcode=\"%s\"} %lu\n", _boosters[b].name,
+                  op < NUM_OPCODES ? OPCODES[op].name : "unknown", (unsigned long) _boosters[b].commands[op]);
+        }
+    }
+
+    print("# HELP dd_booster_bytes_total Bytes sent per opcode, including the parameters.\n# TYPE dd_booster_bytes_total counter\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        for (uint8_t op = 0; op <= NUM_OPCODES; op++) {
+            print("dd_booster_bytes_total{booster=\"%s\",opcode=\"%s\"} %lu\n", _boosters[b].name,
+                  op < NUM_OPCODES ? OPCODES[op].name : "unknown", (unsigned long) _boosters[b].bytes[op]);
+        }
+    }
+
+    print("# HELP dd_booster_transactions_total SPI transactions sent.\n# TYPE dd_booster_transactions_total counter\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        print("dd_booster_transactions_total{booster=\"%s\"} %lu\n", _boosters[b].name, (unsigned long) _boosters[b].transactions);
+    }
+
+    print("# HELP dd_booster_frames_total Frames shown.\n# TYPE dd_booster_frames_total counter\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        print("dd_booster_frames_total{booster=\"%s\"} %lu\n", _boosters[b].name, (unsigned long) _boosters[b].frames);
+    }
+
+    print("# HELP dd_booster_latch_wait_seconds_total Time the LEDs were updated after SHOW.\n# TYPE dd_booster_latch_wait_seconds_total counter\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        print("dd_booster_latch_wait_seconds_total{booster=\"%s\"} %s\n", _boosters[b].name, seconds(text, _boosters[b].latchTime));
+    }
+
+    print("# HELP dd_booster_frame_seconds Time from the first command of a frame until its LEDs are updated.\n# TYPE dd_booster_frame_seconds histogram\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        const Booster &booster = _boosters[b];
+        uint32_t count = 0;
+        for (uint8_t i = 0; i < NUM_BUCKETS; i++) {
+            count += booster.buckets[i];
+            print("dd_booster_frame_seconds_bucket{booster=\"%s\",le=\"%s\"} %lu\n", booster.name, BUCKET_LABELS[i], (unsigned long) count);
+        }
+        print("dd_booster_frame_seconds_sum{booster=\"%s\"} %s\n", booster.name, seconds(text, booster.frameTime));
+        print("dd_booster_frame_seconds_count{booster=\"%s\"} %lu\n", booster.name, (unsigned long) count);
+    }
+
+    print("# HELP dd_booster_encode_seconds Time spent preparing frames, reported by the application.\n# TYPE dd_booster_encode_seconds summary\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        print("dd_booster_encode_seconds_sum{booster=\"%s\"} %s\n", _boosters[b].name, seconds(text, _boosters[b].encodeTime));
+        print("dd_booster_encode_seconds_count{booster=\"%s\"} %lu\n", _boosters[b].name, (unsigned long) _boosters[b].encodeCount);
+    }
+
+    if (!_controller) {
+        return;
+    }
+
+    print("# HELP dd_booster_dropped_frames_total Submits dropped because the previous frame was in progress.\n# TYPE dd_booster_dropped_frames_total counter\n");
+    for (uint8_t b = 0; b < _boosterCount; b++) {
+        if (_boosters[b].strip >= 0) {
+            print("dd_booster_dropped_frames_total{booster=\"%s\"} %lu\n", _boosters[b].name,
+                  (unsigned long) _controller->getDroppedFrames(_boosters[b].strip));
+        }
+    }
+
+    uint8_t buses = _controller->getBusCount();
+    print("# HELP dd_bus_queue_depth Rendered frames waiting for the bus.\n# TYPE dd_bus_queue_depth gauge\n");
+    for (uint8_t bus = 0; bus < buses; bus++) {
+        print("dd_bus_queue_depth{bus=\"%u\"} %u\n", bus, _controller->getQueueDepth(bus));
+    }
+    print("# HELP dd_bus_utilization_ratio Part of the time the bus was sending.\n# TYPE dd_bus_utilization_ratio gauge\n");
+    for (uint8_t bus = 0; bus < buses; bus++) {
+        uint8_t percent = _controller->getUtilization(bus);
+        print("dd_bus_utilization_ratio{bus=\"%u\"} %u.%02u\n", bus, percent / 100, percent % 100);
+    }
+    print("# HELP dd_bus_frames_total Frames sent on the bus.\n# TYPE dd_bus_frames_total counter\n");
+    for (uint8_t bus = 0; bus < buses; bus++) {
+        print("dd_bus_frames_total{bus=\"%u\"} %lu\n", bus, (unsigned long) _controller->getFrameCount(bus));
+    }
+}
+
+void DDMetrics::print(const char *format, ...)
+{
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(_output + _outputLength, sizeof (_output) - _outputLength, format, args);
+        va_end(args);
+        if (length >= 0 && length < (int) (sizeof (_output) - _outputLength)) {
+            _outputLength += length;
+            return;
+        }
+        // does not fit, send what was collected and try again with the empty buffer
+        flushOutput();
+    }
+}
+
+void DDMetrics::flushOutput()
+{
+    if (_file) {
+        fwrite(_output, 1, _outputLength, _file);
+    } else if (_client) {
+        uint16_t sent = 0;
+        while (sent < _outputLength) {
+            nsapi_size_or_error_t length = _client->send(_output + sent, _outputLength - sent);
+            if (length <= 0) {
+                break;
+            }
+            sent += length;
+        }
+    }
+    _outputLength = 0;
+}
+
+#endif // MBED_CONF_NSAPI_PRESENT && MBED_CONF_RTOS_PRESENT
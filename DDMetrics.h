@@ -0,0 +1,146 @@
+/*
+ * DDMetrics.h - Prometheus metrics of Digi-Dot-Boosters served over HTTP
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDMETRICS_H
+#define DD_BOOSTER_DDMETRICS_H
+
+#include "DDBooster.h"
+#include "DDBusController.h"
+#include "TCPSocket.h"
+#include "NetworkInterface.h"
+
+/**
+ * @brief Counts the traffic of DD-Boosters and serves it in the Prometheus text format.
+ *
+ * Every added booster is monitored with DDBooster::attachMonitor() until the metrics are
+ * destroyed, other monitors of the booster are not affected. From the sent transactions the
+ * commands and bytes per opcode, the frames (SHOW commands) and the time the LEDs need to
+ * latch a frame are counted. The time from the first command of a frame to its SHOW plus
+ * the latch time is collected in a histogram.
+ * The encode time has to be reported by the application with recordEncodeTime(). With a
+ * DDBusController attached, the queue depth, utilization and frames of each bus and the
+ * dropped frames of each booster are added.
+ *
+ * The counters are updated in the threads sending to the boosters and read without locking,
+ * a scrape during a transaction may see only a part of its counts.
+ *
+ * open() starts a HTTP server answering "GET /metrics" requests. Like DDOpcServer it works
+ * with non-blocking sockets handled in poll(), only the response is sent blocking.
+ */
+class DDMetrics {
+public:
+
+    /**
+     * Default HTTP port.
+     */
+    static const uint16_t METRICS_PORT = 9464;
+
+    /**
+     * Maximal number of boosters.
+     */
+    static const uint8_t MAX_BOOSTERS = 4;
+
+    /**
+     * Number of histogram buckets including +Inf.
+     */
+    static const uint8_t NUM_BUCKETS = 8;
+
+    DDMetrics();
+
+    ~DDMetrics();
+
+    /**
+     * Adds a booster and attaches the monitor to it.
+     * @param booster - DD-Booster instance
+     * @param name - Value of the "booster" label, must stay valid
+     * @param strip - Strip index of the booster in the attached DDBusController or -1
+     * @return booster index or -1 if MAX_BOOSTERS are already used or the booster has no free
+     *         monitor
+     */
+    int8_t addBooster(DDBooster &booster, const char *name, int8_t strip = -1);
+
+    /**
+     * Adds the bus statistics of a controller.
+     * @param controller - Bus controller sending to the added boosters
+     */
+    void attachController(DDBusController &controller);
+
+    /**
+     * Adds the time spent preparing a frame, e.g. rendering and encoding before it is sent.
+     * @param booster - Booster index returned by addBooster()
+     * @param us - Encode time in microseconds
+     */
+    void recordEncodeTime(uint8_t booster, uint32_t us);
+
+    /**
+     * Opens the listening socket.
+     * @param network - Connected network interface
+     * @param port - TCP port, METRICS_PORT is default
+     * @return NSAPI_ERROR_OK on success
+     */
+    nsapi_error_t open(NetworkInterface *network, uint16_t port = METRICS_PORT);
+
+    /**
+     * Accepts a scrape, reads the request and sends the response.
+     * Call it from the main loop.
+     */
+    void poll();
+
+    /**
+     * Writes all metrics in the Prometheus text format.
+     * @param file - Output, e.g. stdout
+     */
+    void write(FILE *file);
+
+private:
+    static const uint8_t NUM_OPCODES = 15;
+
+    class Booster {
+    public:
+        void onTransaction(const uint8_t *data, uint8_t length);
+
+        DDBooster *booster;
+        int8_t monitor;
+        const char *name;
+        int8_t strip;
+        volatile uint32_t commands[NUM_OPCODES + 1];
+        volatile uint32_t bytes[NUM_OPCODES + 1];
+        volatile uint32_t transactions;
+        volatile uint32_t frames;
+        volatile uint64_t latchTime;
+        bool inFrame;
+        uint32_t frameStart;
+        volatile uint32_t buckets[NUM_BUCKETS];
+        volatile uint64_t frameTime;
+        volatile uint64_t encodeTime;
+        volatile uint32_t encodeCount;
+    };
+
+    void onSignal();
+    void accept();
+    void read();
+    void respond();
+    void closeClient();
+    void writeMetrics();
+    void print(const char *format, ...);
+    void flushOutput();
+
+    Booster _boosters[MAX_BOOSTERS];
+    uint8_t _boosterCount;
+    DDBusController *_controller;
+
+    TCPSocket _server;
+    TCPSocket *_client;
+    volatile bool _signaled;
+    char _request[128];
+    uint8_t _requestLength;
+
+    FILE *_file;
+    char _output[256];
+    uint16_t _outputLength;
+};
+
+#endif //DD_BOOSTER_DDMETRICS_H
@@ -0,0 +1,240 @@
+/*
+ * DDNoise.cpp - Fixed point noise effects (fire, plasma, clouds) for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDNoise.h"
+
+static inline uint8_t hash(uint32_t x, uint32_t y)
+{
+    uint32_t h = x * 0x8DA6B343 ^ y * 0xD8163841;
+    h ^= h >> 13;
+    h *= 0x85EBCA6B;
+    h ^= h >> 16;
+    return h & 0xFF;
+}
+
+// smoothstep 3t^2 - 2t^3 for t in 1/256
+static inline int32_t fade(uint32_t t)
+{
+    return (t * t * (768 - 2 * t)) >> 16;
+}
+
+static inline int32_t lerp(int32_t a, int32_t b, int32_t t)
+{
+    return a + ((b - a) * t >> 8);
+}
+
+// triangle wave used as palette, 0 - 255 - 0 over one period of 256
+static inline uint8_t triangle(uint8_t v)
+{
+    return v < 128 ? v * 2 : (255 - v) * 2;
+}
+
+uint8_t DDNoise::noise1(uint32_t x)
+{
+    uint32_t xi = x >> 8;
+    return lerp(hash(xi, 0), hash(xi + 1, 0), fade(x & 0xFF));
+}
+
+uint8_t DDNoise::noise2(uint32_t x, uint32_t y)
+{
+    uint32_t xi = x >> 8;
+    uint32_t yi = y >> 8;
+    int32_t fx = fade(x & 0xFF);
+    int32_t fy = fade(y & 0xFF);
+    int32_t top = lerp(hash(xi, yi), hash(xi + 1, yi), fx);
+    int32_t bottom = lerp(hash(xi, yi + 1), hash(xi + 1, yi + 1), fx);
+    return lerp(top, bottom, fy);
+}
+
+DDNoiseEffect::DDNoiseEffect()
+    : _alpha(256)
+    , _limit(0)
+    , _next(0)
+    , _renderTime(0)
+{
+    memset(_target, 0, sizeof (_target));
+}
+
+DDNoiseEffect::~DDNoiseEffect()
+{
+}
+
+void DDNoiseEffect::setSmoothing(uint16_t alpha)
+{
+    _alpha = alpha > 256 ? 256 : alpha;
+}
+
+void DDNoiseEffect::setChangeLimit(uint16_t count)
+{
+    _limit = count;
+}
+
+uint32_t DDNoiseEffect::getRenderTime() const
+{
+    return _renderTime;
+}
+
+void DDNoiseEffect::render(DDFrameBuffer &frame)
+{
+    uint16_t count = frame.getSize();
+    uint8_t *data = frame.getData();
+
+    _timer.reset();
+    _timer.start();
+    compute(_target, count);
+    _timer.stop();
+    _renderTime = _timer.read_us();
+
+    if (_limit == 0 || _limit >= count) {
+        // plain loop over all color bytes without dependencies, can be vectorized by the compiler
+        for (uint16_t k = 0; k < count * 3; k++) {
+            int16_t diff = _target[k] - data[k];
+            int16_t step = diff * _alpha >> 8;
+            // make sure small differences still converge
+            step += (step == 0) * ((diff > 0) - (diff < 0));
+            data[k] += step;
+        }
+        return;
+    }
+
+    // limited: continue where the last frame stopped, so every LED gets its turn
+    uint16_t changed = 0;
+    uint16_t n = 0;
+    for (; n < count && changed < _limit; n++) {
+        uint16_t i = (_next + n) % count;
+        uint8_t *px = data + i * 3;
+        const uint8_t *target = _target + i * 3;
+        bool differs = false;
+        for (uint8_t c = 0; c < 3; c++) {
+            int16_t diff = target[c] - px[c];
+            int16_t step = diff * _alpha >> 8;
+            step += (step == 0) * ((diff > 0) - (diff < 0));
+            differs |= step != 0;
+            px[c] += step;
+        }
+        changed += differs;
+    }
+    _next = (_next + n) % count;
+}
+
+DDPlasma::DDPlasma(uint16_t scale, uint16_t speed, uint8_t width)
+    : _scale(scale)
+    , _speed(speed)
+    , _width(width)
+    , _time(0)
+{
+}
+
+void DDPlasma::compute(uint8_t *target, uint16_t count)
+{
+    uint16_t width = _width ? _width : count;
+
+    _time += _speed;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t x = (i % width) * _scale;
+        uint32_t y = (i / width) * _scale;
+        // two noise layers moving in different directions
+        uint8_t v = DDNoise::noise2(x + _time, y) + DDNoise::noise2(x + 0x10000, y + _time);
+        target[i * 3] = triangle(v);
+        target[i * 3 + 1] = triangle(v + 85);
+        target[i * 3 + 2] = triangle(v + 170);
+    }
+}
+
+DDClouds::DDClouds(uint16_t scale, uint16_t speed, const uint8_t sky[3], const uint8_t cloud[3])
+    : _scale(scale)
+    , _speed(speed)
+    , _time(0)
+{
+    memcpy(_sky, sky, 3);
+    memcpy(_cloud, cloud, 3);
+}
+
+void DDClouds::compute(uint8_t *target, uint16_t count)
+{
+    _time += _speed;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t x = i * _scale + _time;
+        uint32_t y = _time >> 2;
+        // two octaves, the second one adds detail
+        int32_t n = (2 * DDNoise::noise2(x, y) + DDNoise::noise2(2 * x, 2 * y)) / 3;
+        // increase contrast to get clear sky between the clouds
+        n = (n - 96) * 2;
+        n = n < 0 ? 0 : (n > 255 ? 255 : n);
+        for (uint8_t c = 0; c < 3; c++) {
+            target[i * 3 + c] = lerp(_sky[c], _cloud[c], n);
+        }
+    }
+}
+
+DDFire::DDFire(uint8_t cooling, uint8_t sparking)
+    : _cooling(cooling)
+    , _sparking(sparking)
+    , _seed(0x2545F491)
+{
+    memset(_heat, 0, sizeof (_heat));
+}
+
+uint8_t DDFire::random8()
+{
+    // xorshift32
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed >> 24;
+}
+
+void DDFire::compute(uint8_t *target, uint16_t count)
+{
+    if (count < 3) {
+        return;
+    }
+
+    // cool down every cell
+    uint16_t maxCooling = _cooling * 10 / count + 2;
+    if (maxCooling > 255) {
+        maxCooling = 255;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t cooldown = random8() % maxCooling;
+        _heat[i] = _heat[i] > cooldown ? _heat[i] - cooldown : 0;
+    }
+
+    // heat drifts up and diffuses
+    for (uint16_t k = count - 1; k >= 2; k--) {
+        _heat[k] = (_heat[k - 1] + 2 * _heat[k - 2]) / 3;
+    }
+
+    // new sparks near the bottom
+    if (random8() < _sparking) {
+        uint8_t y = random8() % 7;
+        if (y < count) {
+            uint16_t heat = _heat[y] + 160 + random8() % 96;
+            _heat[y] = heat > 255 ? 255 : heat;
+        }
+    }
+
+    // black - red - yellow - white
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t t = _heat[i] * 191 / 255;
+        uint8_t ramp = (t & 0x3F) << 2;
+        uint8_t *px = target + i * 3;
+        if (t & 0x80) {
+            px[0] = 255;
+            px[1] = 255;
+            px[2] = ramp;
+        } else if (t & 0x40) {
+            px[0] = 255;
+            px[1] = ramp;
+            px[2] = 0;
+        } else {
+            px[0] = ramp;
+            px[1] = 0;
+            px[2] = 0;
+        }
+    }
+}
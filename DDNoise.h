@@ -0,0 +1,177 @@
+/*
+ * DDNoise.h - Fixed point noise effects (fire, plasma, clouds) for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDNOISE_H
+#define DD_BOOSTER_DDNOISE_H
+
+#include "DDFrameBuffer.h"
+
+/**
+ * @brief Value noise in fixed point arithmetic.
+ *
+ * Coordinates have 8 fractional bits, one lattice cell is 256 units wide. The random lattice
+ * values are interpolated with a smoothstep curve. Only integer operations are used, so the
+ * functions run on MCUs without FPU.
+ */
+class DDNoise {
+public:
+
+    /**
+     * Returns 1D noise.
+     * @param x - Coordinate with 8 fractional bits
+     * @return noise value (0 - 255)
+     */
+    static uint8_t noise1(uint32_t x);
+
+    /**
+     * Returns 2D noise.
+     * @param x - X coordinate with 8 fractional bits
+     * @param y - Y coordinate with 8 fractional bits
+     * @return noise value (0 - 255)
+     */
+    static uint8_t noise2(uint32_t x, uint32_t y);
+};
+
+/**
+ * @brief Base class of the effects rendering a complete frame on the MCU.
+ *
+ * The effect computes the target colors of all LEDs. render() moves the frame buffer
+ * towards the target:
+ * - smoothing blends the previous frame with the target, so LEDs change in small steps
+ *   and many of them keep their value between two frames
+ * - the change limit bounds the number of LEDs changed per frame, so a frame never needs
+ *   more bus time than available. LEDs not updated in one frame are updated first in the
+ *   next one.
+ *
+ * getRenderTime() returns the time the last compute step took, to check the CPU budget.
+ */
+class DDNoiseEffect {
+public:
+
+    DDNoiseEffect();
+
+    virtual ~DDNoiseEffect();
+
+    /**
+     * Sets the blending factor between the previous frame and the target.
+     * @param alpha - Part of the target in 1/256, 256 disables smoothing (default)
+     */
+    void setSmoothing(uint16_t alpha);
+
+    /**
+     * Sets the maximal number of LEDs changed per frame.
+     * @param count - Number of LEDs, 0 disables the limit (default)
+     */
+    void setChangeLimit(uint16_t count);
+
+    /**
+     * Computes the next frame and updates the frame buffer. Call flush() of the frame buffer afterwards.
+     * @param frame - Frame buffer to render to
+     */
+    void render(DDFrameBuffer &frame);
+
+    /**
+     * Returns the time in microseconds the last compute step took.
+     */
+    uint32_t getRenderTime() const;
+
+protected:
+
+    /**
+     * Computes the target colors of the next frame.
+     * @param target - RGB triplets to fill
+     * @param count - Number of LEDs
+     */
+    virtual void compute(uint8_t *target, uint16_t count) = 0;
+
+private:
+    uint8_t _target[DDFrameBuffer::MAX_LEDS * 3];
+    uint16_t _alpha;
+    uint16_t _limit;
+    uint16_t _next;
+    uint32_t _renderTime;
+    Timer _timer;
+};
+
+/**
+ * @brief Moving colorful plasma based on 2D noise.
+ *
+ * The noise is sampled over x (LED) and time, or over x, y and time for matrices
+ * with rows of width LEDs starting at LED 0.
+ */
+class DDPlasma : public DDNoiseEffect {
+public:
+
+    /**
+     * @param scale - Distance between two LEDs in the noise space, in 1/256 cell
+     * @param speed - Time step per frame, in 1/256 cell
+     * @param width - Number of LEDs in one matrix row, 0 for a strip
+     */
+    DDPlasma(uint16_t scale, uint16_t speed, uint8_t width = 0);
+
+protected:
+    virtual void compute(uint8_t *target, uint16_t count);
+
+private:
+    uint16_t _scale;
+    uint16_t _speed;
+    uint8_t _width;
+    uint32_t _time;
+};
+
+/**
+ * @brief Slowly drifting clouds: 2D noise blended between a sky and a cloud color.
+ */
+class DDClouds : public DDNoiseEffect {
+public:
+
+    /**
+     * @param scale - Distance between two LEDs in the noise space, in 1/256 cell
+     * @param speed - Drift per frame, in 1/256 cell
+     * @param sky - RGB color of the sky
+     * @param cloud - RGB color of the clouds
+     */
+    DDClouds(uint16_t scale, uint16_t speed, const uint8_t sky[3], const uint8_t cloud[3]);
+
+protected:
+    virtual void compute(uint8_t *target, uint16_t count);
+
+private:
+    uint16_t _scale;
+    uint16_t _speed;
+    uint32_t _time;
+    uint8_t _sky[3];
+    uint8_t _cloud[3];
+};
+
+/**
+ * @brief Fire simulation with rising heat starting at LED 0.
+ *
+ * Each frame every cell cools down, the heat drifts up and new sparks appear near the
+ * bottom. The heat is mapped to black - red - yellow - white.
+ */
+class DDFire : public DDNoiseEffect {
+public:
+
+    /**
+     * @param cooling - Cooling per frame, higher values make shorter flames. Recommended 20 - 100
+     * @param sparking - Chance of a new spark per frame in 1/256. Recommended 50 - 200
+     */
+    DDFire(uint8_t cooling, uint8_t sparking);
+
+protected:
+    virtual void compute(uint8_t *target, uint16_t count);
+
+private:
+    uint8_t random8();
+
+    uint8_t _cooling;
+    uint8_t _sparking;
+    uint32_t _seed;
+    uint8_t _heat[DDFrameBuffer::MAX_LEDS];
+};
+
+#endif //DD_BOOSTER_DDNOISE_H
@@ -0,0 +1,277 @@
+/*
+ * DDOpcServer.cpp - Open Pixel Control TCP server for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_NSAPI_PRESENT
+
+#include "DDOpcServer.h"
+
+#define OPC_CMD_SET_PIXELS   0
+#define OPC_BROADCAST        0
+
+DDOpcServer::DDOpcServer()
+    : _signaled(false)
+{
+    memset(_clients, 0, sizeof (_clients));
+    memset(_channels, 0, sizeof (_channels));
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        _channels[i].client = -1;
+    }
+    _timer.start();
+}
+
+DDOpcServer::~DDOpcServer()
+{
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        closeClient(i);
+    }
+    _server.close();
+}
+
+bool DDOpcServer::addSegment(uint8_t channel, DDFrameBuffer &frame)
+{
+    if (channel < 1 || channel > MAX_CHANNELS) {
+        return false;
+    }
+    Channel &c = _channels[channel - 1];
+    if (c.segmentCount >= MAX_SEGMENTS) {
+        return false;
+    }
+    c.segments[c.segmentCount++] = &frame;
+    return true;
+}
+
+nsapi_error_t DDOpcServer::open(NetworkInterface *network, uint16_t port)
+{
+    nsapi_error_t result = _server.open(network);
+    if (result != NSAPI_ERROR_OK) {
+        return result;
+    }
+    result = _server.bind(port);
+    if (result == NSAPI_ERROR_OK) {
+        result = _server.listen(MAX_CLIENTS);
+    }
+    if (result != NSAPI_ERROR_OK) {
+        _server.close();
+        return result;
+    }
+    _server.set_blocking(false);
+    _server.sigio(callback(this, &DDOpcServer::onSignal));
+    _signaled = true;
+    return NSAPI_ERROR_OK;
+}
+
+void DDOpcServer::onSignal()
+{
+    // called from the network stack context, the work is done in poll()
+    _signaled = true;
+}
+
+void DDOpcServer::poll()
+{
+    if (_signaled) {
+        _signaled = false;
+        accept();
+        for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+            if (_clients[i].socket && read(i)) {
+                // the rest is read in the next call, there will be no new signal for it
+                _signaled = true;
+            }
+        }
+    }
+    flushChannels();
+}
+
+DDOpcServer::ClientStats DDOpcServer::getClientStats(uint8_t index) const
+{
+    ClientStats stats;
+    memset(&stats, 0, sizeof (stats));
+    if (index >= MAX_CLIENTS) {
+        return stats;
+    }
+    const Client &c = _clients[index];
+    stats.connected = c.socket != NULL;
+    stats.bytes = c.bytes;
+    stats.frames = c.frames;
+    stats.coalesced = c.coalesced;
+    stats.latencyMax = c.latencyMax;
+    stats.latencyAverage = c.latencyCount ? c.latencySum / c.latencyCount : 0;
+    return stats;
+}
+
+void DDOpcServer::accept()
+{
+    while (true) {
+        nsapi_error_t error;
+        TCPSocket *socket = _server.accept(&error);
+        if (!socket) {
+            break;
+        }
+
+        uint8_t i = 0;
+        while (i < MAX_CLIENTS && _clients[i].socket) {
+            i++;
+        }
+        if (i == MAX_CLIENTS) {
+            socket->close();
+            continue;
+        }
+
+        memset(&_clients[i], 0, sizeof (Client));
+        _clients[i].socket = socket;
+        socket->set_blocking(false);
+        socket->sigio(callback(this, &DDOpcServer::onSignal));
+    }
+}
+
+bool DDOpcServer::read(uint8_t index)
+{
+    Client &c = _clients[index];
+    uint16_t total = 0;
+    while (c.socket) {
+        if (total >= MAX_READ_BYTES) {
+            return true;
+        }
+        nsapi_size_or_error_t length = c.socket->recv(_buffer, sizeof (_buffer));
+        if (length == NSAPI_ERROR_WOULD_BLOCK) {
+            break;
+        }
+        if (length <= 0) {
+            // connection closed by the client or failed
+            closeClient(index);
+            break;
+        }
+        c.bytes += length;
+        total += length;
+        parse(index, _buffer, length);
+    }
+    return false;
+}
+
+void DDOpcServer::parse(uint8_t index, const uint8_t *data, uint16_t length)
+{
+    Client &c = _clients[index];
+
+    while (length > 0) {
+        if (c.headerLength < 4) {
+            c.header[c.headerLength++] = *data++;
+            length--;
+            if (c.headerLength == 4) {
+                c.remaining = (c.header[2] << 8) | c.header[3];
+                c.offset = 0;
+                if (c.remaining == 0) {
+                    c.headerLength = 0;
+                }
+            }
+            continue;
+        }
+
+        uint16_t count = length < c.remaining ? length : c.remaining;
+        if (c.header[1] == OPC_CMD_SET_PIXELS) {
+            writePixels(c.header[0], c.offset, data, count);
+        }
+        c.offset += count;
+        c.remaining -= count;
+        data += count;
+        length -= count;
+
+        if (c.remaining == 0) {
+            if (c.header[1] == OPC_CMD_SET_PIXELS) {
+                completeFrame(index, c.header[0]);
+            }
+            c.headerLength = 0;
+        }
+    }
+}
+
+void DDOpcServer::writePixels(uint8_t channel, uint16_t offset, const uint8_t *data, uint16_t length)
+{
+    for (uint8_t ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (channel != OPC_BROADCAST && channel != ch + 1) {
+            continue;
+        }
+
+        // collect the pixels in the receive buffer, the frame buffers keep the last frame
+        Channel &c = _channels[ch];
+        if (offset >= sizeof (c.pixels)) {
+            continue;
+        }
+        uint16_t count = offset + length > sizeof (c.pixels) ? sizeof (c.pixels) - offset : length;
+        memcpy(c.pixels + offset, data, count);
+        if (offset + count > c.received) {
+            c.received = offset + count;
+        }
+    }
+}
+
+void DDOpcServer::completeFrame(uint8_t index, uint8_t channel)
+{
+    Client &c = _clients[index];
+    c.frames++;
+
+    for (uint8_t ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (channel != OPC_BROADCAST && channel != ch + 1) {
+            continue;
+        }
+        Channel &target = _channels[ch];
+
+        // copy the received part overlapping each segment of the logical strip
+        uint16_t segmentStart = 0;
+        for (uint8_t s = 0; s < target.segmentCount && segmentStart < target.received; s++) {
+            uint16_t segmentEnd = segmentStart + target.segments[s]->getSize() * 3;
+            uint16_t to = target.received < segmentEnd ? target.received : segmentEnd;
+            memcpy(target.segments[s]->getData(), target.pixels + segmentStart, to - segmentStart);
+            segmentStart = segmentEnd;
+        }
+        target.received = 0;
+
+        if (target.dirty) {
+            // the previous frame was not sent yet and is replaced by this one
+            c.coalesced++;
+        }
+        target.dirty = true;
+        target.client = index;
+        target.receivedAt = _timer.read_us();
+    }
+}
+
+void DDOpcServer::flushChannels()
+{
+    for (uint8_t ch = 0; ch < MAX_CHANNELS; ch++) {
+        Channel &c = _channels[ch];
+        if (!c.dirty) {
+            continue;
+        }
+
+        // the frame buffers only contain complete frames, they can be sent at any time
+        for (uint8_t s = 0; s < c.segmentCount; s++) {
+            c.segments[s]->flush();
+        }
+        c.dirty = false;
+
+        if (c.client >= 0) {
+            Client &client = _clients[c.client];
+            uint32_t latency = _timer.read_us() - c.receivedAt;
+            client.latencySum += latency;
+            client.latencyCount++;
+            if (latency > client.latencyMax) {
+                client.latencyMax = latency;
+            }
+        }
+    }
+}
+
+void DDOpcServer::closeClient(uint8_t index)
+{
+    Client &c = _clients[index];
+    if (c.socket) {
+        // closing an accepted socket also releases it
+        c.socket->close();
+        c.socket = NULL;
+    }
+}
+
+#endif // MBED_CONF_NSAPI_PRESENT
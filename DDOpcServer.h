@@ -0,0 +1,150 @@
+/*
+ * DDOpcServer.h - Open Pixel Control TCP server for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDOPCSERVER_H
+#define DD_BOOSTER_DDOPCSERVER_H
+
+#include "DDFrameBuffer.h"
+#include "TCPSocket.h"
+#include "NetworkInterface.h"
+
+/**
+ * @brief Accepts Open Pixel Control clients and sends their frames to the DD-Booster.
+ *
+ * Each OPC channel is mapped to one or more frame buffers. Several frame buffers form one
+ * logical strip, pixel data continues in the next frame buffer when one is full.
+ * Channel 0 is the OPC broadcast channel and writes to all channels.
+ *
+ * All sockets are non-blocking. The sockets signal incoming data and connections, poll()
+ * reads only when something happened, at most MAX_READ_BYTES per client and call, so a fast
+ * sender cannot keep the channels from being sent. Incoming pixels are collected in a
+ * receive buffer per channel and copied into the frame buffers when the message is
+ * complete, a partially received frame is never sent. The channel is then marked for
+ * sending. Channels are sent at the end of poll(), so if a client sends faster than the bus
+ * can drain, the frames received in the meantime are coalesced and only the latest one is
+ * sent.
+ *
+ * The receive buffers take MAX_CHANNELS * MAX_SEGMENTS * DDFrameBuffer::MAX_LEDS * 3 bytes
+ * (12 KB) of the server object.
+ *
+ * Per client the received bytes, frames, coalesced frames and the latency from the complete
+ * reception of a frame to the end of its flush are recorded.
+ */
+class DDOpcServer {
+public:
+
+    /**
+     * Default OPC TCP port.
+     */
+    static const uint16_t OPC_PORT = 7890;
+
+    /**
+     * Maximal number of bytes read from one client per poll() call.
+     */
+    static const uint16_t MAX_READ_BYTES = 2048;
+
+    /**
+     * Maximal number of channels.
+     */
+    static const uint8_t MAX_CHANNELS = 4;
+
+    /**
+     * Maximal number of frame buffers per channel.
+     */
+    static const uint8_t MAX_SEGMENTS = 4;
+
+    /**
+     * Maximal number of connected clients.
+     */
+    static const uint8_t MAX_CLIENTS = 4;
+
+    /**
+     * Statistics of one client.
+     */
+    struct ClientStats {
+        bool connected;
+        uint32_t bytes;
+        uint32_t frames;
+        uint32_t coalesced;
+        uint32_t latencyMax;
+        uint32_t latencyAverage;
+    };
+
+    DDOpcServer();
+
+    ~DDOpcServer();
+
+    /**
+     * Appends a frame buffer to the logical strip of a channel.
+     * @param channel - OPC channel (1 - MAX_CHANNELS)
+     * @param frame - Frame buffer receiving the next pixels of the channel
+     * @return false if the channel is invalid or has no free segment
+     */
+    bool addSegment(uint8_t channel, DDFrameBuffer &frame);
+
+    /**
+     * Opens the listening socket.
+     * @param network - Connected network interface
+     * @param port - TCP port, OPC_PORT is default
+     * @return NSAPI_ERROR_OK on success
+     */
+    nsapi_error_t open(NetworkInterface *network, uint16_t port = OPC_PORT);
+
+    /**
+     * Accepts new clients, reads the available data and sends the changed channels.
+     * Call it from the main loop.
+     */
+    void poll();
+
+    /**
+     * Returns the statistics of a client slot.
+     * @param index - Client slot (0 - MAX_CLIENTS-1)
+     */
+    ClientStats getClientStats(uint8_t index) const;
+
+private:
+    struct Client {
+        TCPSocket *socket;
+        uint8_t header[4];
+        uint8_t headerLength;
+        uint16_t remaining;
+        uint16_t offset;
+        uint32_t bytes;
+        uint32_t frames;
+        uint32_t coalesced;
+        uint32_t latencyMax;
+        uint64_t latencySum;
+        uint32_t latencyCount;
+    };
+
+    struct Channel {
+        DDFrameBuffer *segments[MAX_SEGMENTS];
+        uint8_t segmentCount;
+        bool dirty;
+        int8_t client;
+        uint32_t receivedAt;
+        uint16_t received;
+        uint8_t pixels[MAX_SEGMENTS * DDFrameBuffer::MAX_LEDS * 3];
+    };
+
+    void onSignal();
+    void accept();
+    bool read(uint8_t index);
+    void parse(uint8_t index, const uint8_t *data, uint16_t length);
+    void writePixels(uint8_t channel, uint16_t offset, const uint8_t *data, uint16_t length);
+    void completeFrame(uint8_t index, uint8_t channel);
+    void flushChannels();
+    void closeClient(uint8_t index);
+
+    TCPSocket _server;
+    Client _clients[MAX_CLIENTS];
+    Channel _channels[MAX_CHANNELS];
+    Timer _timer;
+    volatile bool _signaled;
+    uint8_t _buffer[512];
+};
+
+#endif //DD_BOOSTER_DDOPCSERVER_H
@@ -0,0 +1,189 @@
+/*
+ * DDParticles.h - Particle system for LED strips rendering into a DDFrameBuffer
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDPARTICLES_H
+#define DD_BOOSTER_DDPARTICLES_H
+
+#include "DDFrameBuffer.h"
+
+/**
+ * @brief Particle system with a fixed number of particles for sparks, rain or fireworks.
+ *
+ * The particle pool is sized at compile time, no heap is used. Live particles are kept
+ * packed at the beginning of the pool, so spawning takes the next free slot and a dying
+ * particle is replaced by the last live one. Both operations take constant time.
+ * The particle properties are stored as separate arrays which keeps the update loop
+ * simple and cache friendly.
+ *
+ * Positions and velocities are fixed point values with 8 fractional bits, given in LEDs
+ * and LEDs per frame. A particle is drawn into the two LEDs next to its position with
+ * its brightness split by the fractional part, its brightness fades with its life.
+ *
+ * Particles touch only a few LEDs per frame, so the difference encoding of the frame
+ * buffer keeps the bus load low.
+ *
+ * @tparam N - Maximal number of live particles
+ */
+template <uint16_t N>
+class DDParticles {
+public:
+
+    /**
+     * Creates an empty particle system.
+     * @param length - Number of LEDs, particles leaving the strip die
+     */
+    DDParticles(uint16_t length)
+        : _count(0)
+        , _length(length)
+        , _gravity(0)
+        , _drag(256)
+        , _decay(4)
+    {
+    }
+
+    /**
+     * Sets the acceleration added to the velocity each frame.
+     * @param gravity - Acceleration in 1/256 LED per frame squared. Positive values pull towards the end of the strip
+     */
+    void setGravity(int16_t gravity)
+    {
+        _gravity = gravity;
+    }
+
+    /**
+     * Sets the factor the velocity is multiplied with each frame.
+     * @param drag - Factor in 1/256, 256 keeps the velocity
+     */
+    void setDrag(uint16_t drag)
+    {
+        _drag = drag;
+    }
+
+    /**
+     * Sets the life lost by each particle per frame.
+     * @param decay - Life decrement per frame (1 - 255)
+     */
+    void setDecay(uint8_t decay)
+    {
+        _decay = decay;
+    }
+
+    /**
+     * Creates a new particle.
+     * @param position - Start position in 1/256 LED
+     * @param velocity - Velocity in 1/256 LED per frame
+     * @param r - Red part of the color value (0 - 255)
+     * @param g - Green part of the color value (0 - 255)
+     * @param b - Blue part of the color value (0 - 255)
+     * @param life - Start life and brightness (1 - 255)
+     * @return false if the pool is full
+     */
+    bool spawn(int32_t position, int16_t velocity, uint8_t r, uint8_t g, uint8_t b, uint8_t life = 255)
+    {
+        if (_count >= N) {
+            return false;
+        }
+        uint16_t i = _count++;
+        _position[i] = position;
+        _velocity[i] = velocity;
+        _r[i] = r;
+        _g[i] = g;
+        _b[i] = b;
+        _life[i] = life;
+        return true;
+    }
+
+    /**
+     * Moves all particles by one frame and removes dead particles.
+     */
+    void update()
+    {
+        int32_t end = (int32_t) _length << 8;
+
+        // iterate backwards, a dying particle is replaced by the last one which was already updated
+        for (uint16_t n = _count; n > 0; n--) {
+            uint16_t i = n - 1;
+            int32_t velocity = ((int32_t) _velocity[i] * _drag >> 8) + _gravity;
+            if (velocity > 32767) {
+                velocity = 32767;
+            } else if (velocity < -32768) {
+                velocity = -32768;
+            }
+            _velocity[i] = velocity;
+            _position[i] += velocity;
+
+            if (_life[i] <= _decay || _position[i] < -256 || _position[i] >= end) {
+                kill(i);
+            } else {
+                _life[i] -= _decay;
+            }
+        }
+    }
+
+    /**
+     * Clears the frame and draws all particles. Colors of overlapping particles are added.
+     * Call flush() of the frame buffer afterwards.
+     * @param frame - Frame buffer to draw to
+     */
+    void render(DDFrameBuffer &frame)
+    {
+        frame.clear();
+        for (uint16_t i = 0; i < _count; i++) {
+            int32_t led = _position[i] >> 8;
+            uint16_t upper = (_position[i] & 0xFF) * _life[i] >> 8;
+            uint16_t lower = _life[i] - upper;
+            if (led >= 0) {
+                frame.addPixel(led, _r[i] * lower >> 8, _g[i] * lower >> 8, _b[i] * lower >> 8);
+            }
+            if (led + 1 < _length) {
+                frame.addPixel(led + 1, _r[i] * upper >> 8, _g[i] * upper >> 8, _b[i] * upper >> 8);
+            }
+        }
+    }
+
+    /**
+     * Returns the number of live particles.
+     */
+    uint16_t getCount() const
+    {
+        return _count;
+    }
+
+    /**
+     * Removes all particles.
+     */
+    void clear()
+    {
+        _count = 0;
+    }
+
+private:
+    void kill(uint16_t i)
+    {
+        uint16_t last = --_count;
+        _position[i] = _position[last];
+        _velocity[i] = _velocity[last];
+        _r[i] = _r[last];
+        _g[i] = _g[last];
+        _b[i] = _b[last];
+        _life[i] = _life[last];
+    }
+
+    uint16_t _count;
+    uint16_t _length;
+    int16_t _gravity;
+    uint16_t _drag;
+    uint8_t _decay;
+
+    int32_t _position[N];
+    int16_t _velocity[N];
+    uint8_t _r[N];
+    uint8_t _g[N];
+    uint8_t _b[N];
+    uint8_t _life[N];
+};
+
+#endif //DD_BOOSTER_DDPARTICLES_H
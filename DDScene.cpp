@@ -0,0 +1,511 @@
+/*
+ * DDScene.cpp - Scene script compiler and command stream player for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDScene.h"
+#include "DDBoosterProtocol.h"
+
+#define SCENE_MAX_LOOPS      4
+
+static bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char *skipSpace(const char *p, const char *end)
+{
+    while (p < end && isSpace(*p)) {
+        p++;
+    }
+    return p;
+}
+
+// compares the next word with a keyword and moves behind it on success
+static bool keyword(const char *&p, const char *end, const char *word)
+{
+    const char *q = p;
+    while (*word) {
+        if (q >= end || *q != *word) {
+            return false;
+        }
+        q++;
+        word++;
+    }
+    if (q < end && !isSpace(*q)) {
+        return false;
+    }
+    p = skipSpace(q, end);
+    return true;
+}
+
+static const char *lineEnd(const char *p)
+{
+    while (*p && *p != '\n' && *p != '#') {
+        p++;
+    }
+    return p;
+}
+
+static const char *nextLine(const char *p)
+{
+    while (*p && *p != '\n') {
+        p++;
+    }
+    return *p ? p + 1 : p;
+}
+
+DDSceneCompiler::DDSceneCompiler(uint8_t *output, uint32_t capacity)
+    : _output(output)
+    , _capacity(capacity)
+    , _length(0)
+    , _error(NULL)
+    , _line(0)
+{
+}
+
+bool DDSceneCompiler::compile(const char *script)
+{
+    struct {
+        const char *body;
+        uint16_t line;
+        uint32_t remaining;
+    } loops[SCENE_MAX_LOOPS];
+    uint8_t depth = 0;
+
+    _length = 0;
+    _error = NULL;
+    _line = 0;
+    _ledCount = 256;
+    _delay = 0;
+    _lastMergeable = false;
+    _colorLength = 0;
+    _pendingLength = 0;
+
+    const char *p = script;
+    while (*p) {
+        const char *line = p;
+        const char *end = lineEnd(line);
+        p = nextLine(line);
+        _line++;
+
+        const char *q = skipSpace(line, end);
+        if (q == end) {
+            continue;
+        }
+
+        int32_t count;
+        if (keyword(q, end, "loop")) {
+            if (!arguments(q, end, &count, 1)) {
+                return false;
+            }
+            if (depth == SCENE_MAX_LOOPS) {
+                return fail("loops nested too deep");
+            }
+            if (count < 1) {
+                return fail("invalid loop count");
+            }
+            loops[depth].body = p;
+            loops[depth].line = _line;
+            loops[depth].remaining = count - 1;
+            depth++;
+        } else if (keyword(q, end, "end")) {
+            if (q != end) {
+                return fail("unexpected argument");
+            }
+            if (depth == 0) {
+                return fail("end without loop");
+            }
+            if (loops[depth - 1].remaining > 0) {
+                // the loop body is compiled again, unrolled into the stream
+                loops[depth - 1].remaining--;
+                p = loops[depth - 1].body;
+                _line = loops[depth - 1].line;
+            } else {
+                depth--;
+            }
+        } else if (!statement(q, end)) {
+            return false;
+        }
+    }
+
+    if (depth > 0) {
+        _line = loops[depth - 1].line;
+        return fail("loop without end");
+    }
+    if (_delay) {
+        // a trailing wait is kept in an empty record, otherwise a loop would restart at once
+        record(NULL, 0);
+    }
+    return _error == NULL;
+}
+
+bool DDSceneCompiler::statement(const char *p, const char *end)
+{
+    int32_t v[8];
+
+    if (keyword(p, end, "leds")) {
+        if (!arguments(p, end, v, 1)) {
+            return false;
+        }
+        if (v[0] < 1 || v[0] > 256) {
+            return fail("invalid LED count");
+        }
+        _ledCount = v[0];
+    } else if (keyword(p, end, "rgb")) {
+        if (!arguments(p, end, v, 3) || !checkBytes(v, 3)) {
+            return false;
+        }
+        _pending[0] = BOOSTER_SETRGB;
+        _pending[1] = v[0];
+        _pending[2] = v[1];
+        _pending[3] = v[2];
+        _pendingLength = 4;
+    } else if (keyword(p, end, "hsv")) {
+        if (!arguments(p, end, v, 3) || !checkBytes(v + 1, 2)) {
+            return false;
+        }
+        if (v[0] > 359) {
+            v[0] = 359;
+        }
+        _pending[0] = BOOSTER_SETHSV;
+        _pending[1] = v[0] & 0xFF;
+        _pending[2] = v[0] >> 8;
+        _pending[3] = v[1];
+        _pending[4] = v[2];
+        _pendingLength = 5;
+    } else if (keyword(p, end, "led")) {
+        if (!arguments(p, end, v, 1) || !checkIndex(v[0])) {
+            return false;
+        }
+        uint8_t cmd[] = {BOOSTER_SETLED, (uint8_t) v[0]};
+        useColor(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "range")) {
+        if (!arguments(p, end, v, 2) || !checkIndex(v[0]) || !checkIndex(v[1])) {
+            return false;
+        }
+        if (v[0] > v[1]) {
+            return fail("invalid range");
+        }
+        uint8_t cmd[] = {BOOSTER_SETRANGE, (uint8_t) v[0], (uint8_t) v[1]};
+        useColor(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "all")) {
+        if (!arguments(p, end, v, 0)) {
+            return false;
+        }
+        uint8_t cmd[] = {BOOSTER_SETALL};
+        useColor(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "rainbow")) {
+        if (!arguments(p, end, v, 6) || !checkBytes(v + 1, 2) || !checkBytes(v + 5, 1)
+                || !checkIndex(v[3]) || !checkIndex(v[4])) {
+            return false;
+        }
+        if (v[3] > v[4]) {
+            return fail("invalid range");
+        }
+        if (v[0] > 359) {
+            v[0] = 359;
+        }
+        uint8_t cmd[] = {
+            BOOSTER_SETRAINBOW,
+            (uint8_t) (v[0] & 0xFF),
+            (uint8_t) (v[0] >> 8),
+            (uint8_t) v[1],
+            (uint8_t) v[2],
+            (uint8_t) v[3],
+            (uint8_t) v[4],
+            (uint8_t) v[5]
+        };
+        command(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "gradient")) {
+        if (!arguments(p, end, v, 8) || !checkBytes(v + 2, 6) || !checkIndex(v[0]) || !checkIndex(v[1])) {
+            return false;
+        }
+        if (v[0] > v[1]) {
+            return fail("invalid range");
+        }
+        // lowered like DDBooster::setGradient() to one color and LED per transaction,
+        // equal neighbours are merged into ranges by useColor()
+        int32_t steps = v[1] - v[0];
+        for (int32_t s = 0; s <= steps; s++) {
+            _pending[0] = BOOSTER_SETRGB;
+            for (uint8_t c = 0; c < 3; c++) {
+                _pending[1 + c] = steps ? v[2 + c] + (v[5 + c] - v[2 + c]) * s / steps : v[2 + c];
+            }
+            _pendingLength = 4;
+            uint8_t cmd[] = {BOOSTER_SETLED, (uint8_t) (v[0] + s)};
+            useColor(cmd, sizeof (cmd));
+        }
+    } else if (keyword(p, end, "shift")) {
+        uint8_t opcode;
+        if (keyword(p, end, "up")) {
+            opcode = BOOSTER_SHIFTUP;
+        } else if (keyword(p, end, "down")) {
+            opcode = BOOSTER_SHIFTDOWN;
+        } else {
+            return fail("expected up or down");
+        }
+        if (!arguments(p, end, v, 3) || !checkBytes(v + 2, 1) || !checkIndex(v[0]) || !checkIndex(v[1])) {
+            return false;
+        }
+        if (v[0] > v[1]) {
+            return fail("invalid range");
+        }
+        uint8_t cmd[] = {opcode, (uint8_t) v[0], (uint8_t) v[1], (uint8_t) v[2]};
+        command(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "copy")) {
+        if (!arguments(p, end, v, 2) || !checkIndex(v[0]) || !checkIndex(v[1])) {
+            return false;
+        }
+        uint8_t cmd[] = {BOOSTER_COPYLED, (uint8_t) v[0], (uint8_t) v[1]};
+        command(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "repeat")) {
+        if (!arguments(p, end, v, 3) || !checkBytes(v + 2, 1) || !checkIndex(v[0]) || !checkIndex(v[1])) {
+            return false;
+        }
+        if (v[0] > v[1]) {
+            return fail("invalid range");
+        }
+        uint8_t cmd[] = {BOOSTER_REPEAT, (uint8_t) v[0], (uint8_t) v[1], (uint8_t) v[2]};
+        command(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "show")) {
+        if (!arguments(p, end, v, 0)) {
+            return false;
+        }
+        uint8_t cmd[] = {BOOSTER_SHOW};
+        command(cmd, sizeof (cmd));
+    } else if (keyword(p, end, "wait")) {
+        if (!arguments(p, end, v, 1)) {
+            return false;
+        }
+        _delay += v[0];
+    } else {
+        return fail("unknown statement");
+    }
+    return _error == NULL;
+}
+
+bool DDSceneCompiler::arguments(const char *&p, const char *end, int32_t *values, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        if (p == end || *p < '0' || *p > '9') {
+            return fail("expected a number");
+        }
+        int32_t value = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value = value * 10 + (*p - '0');
+            if (value > 0xFFFFFF) {
+                return fail("number too large");
+            }
+            p++;
+        }
+        if (p < end && !isSpace(*p)) {
+            return fail("expected a number");
+        }
+        values[i] = value;
+        p = skipSpace(p, end);
+    }
+    if (p != end) {
+        return fail("unexpected argument");
+    }
+    return true;
+}
+
+bool DDSceneCompiler::checkIndex(int32_t index)
+{
+    if (index >= _ledCount) {
+        return fail("LED index out of range");
+    }
+    return true;
+}
+
+bool DDSceneCompiler::checkBytes(const int32_t *values, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        if (values[i] > 255) {
+            return fail("value out of range");
+        }
+    }
+    return true;
+}
+
+void DDSceneCompiler::useColor(const uint8_t *target, uint8_t length)
+{
+    if (_pendingLength == 0) {
+        fail("no color set");
+        return;
+    }
+
+    bool changed = _pendingLength != _colorLength || memcmp(_pending, _color, _pendingLength) != 0;
+
+    if (!changed && _delay == 0 && _lastMergeable && target[0] == BOOSTER_SETLED) {
+        // the last transaction set the LED before this one to the same color: extend it to a range
+        uint8_t *cmd = _output + _lastTarget;
+        uint8_t first = cmd[1];
+        uint8_t previous = cmd[0] == BOOSTER_SETLED ? cmd[1] : cmd[2];
+        if (previous + 1 == target[1]) {
+            if (cmd[0] == BOOSTER_SETLED) {
+                if (_length + 1 > _capacity) {
+                    fail("output buffer too small");
+                    return;
+                }
+                _output[_lastRecord]++;
+                _length++;
+            }
+            cmd[0] = BOOSTER_SETRANGE;
+            cmd[1] = first;
+            cmd[2] = target[1];
+            return;
+        }
+    }
+
+    uint8_t cmd[8];
+    uint8_t size = 0;
+    if (changed) {
+        memcpy(cmd, _pending, _pendingLength);
+        size = _pendingLength;
+        memcpy(_color, _pending, _pendingLength);
+        _colorLength = _pendingLength;
+    }
+    memcpy(cmd + size, target, length);
+    command(cmd, size + length);
+    _lastTarget = _length - length;
+    _lastMergeable = target[0] == BOOSTER_SETLED || target[0] == BOOSTER_SETRANGE;
+}
+
+void DDSceneCompiler::command(const uint8_t *bytes, uint8_t length)
+{
+    record(bytes, length);
+    _lastMergeable = false;
+}
+
+void DDSceneCompiler::record(const uint8_t *bytes, uint8_t length)
+{
+    uint8_t header[6];
+    uint8_t size = 0;
+    uint32_t delay = _delay;
+    do {
+        header[size] = delay & 0x7F;
+        delay >>= 7;
+        if (delay) {
+            header[size] |= 0x80;
+        }
+        size++;
+    } while (delay);
+    header[size++] = length;
+
+    if (_length + size + length > _capacity) {
+        fail("output buffer too small");
+        return;
+    }
+    memcpy(_output + _length, header, size);
+    _lastRecord = _length + size - 1;
+    if (length > 0) {
+        memcpy(_output + _length + size, bytes, length);
+    }
+    _length += size + length;
+    _delay = 0;
+}
+
+bool DDSceneCompiler::fail(const char *error)
+{
+    if (!_error) {
+        _error = error;
+    }
+    return false;
+}
+
+uint32_t DDSceneCompiler::getLength() const
+{
+    return _length;
+}
+
+const char *DDSceneCompiler::getError() const
+{
+    return _error;
+}
+
+uint16_t DDSceneCompiler::getErrorLine() const
+{
+    return _error ? _line : 0;
+}
+
+DDScenePlayer::DDScenePlayer(DDBooster &booster, const uint8_t *stream, uint32_t length, bool loop)
+    : _booster(booster)
+    , _stream(stream)
+    , _length(length)
+    , _loop(loop)
+    , _position(0)
+    , _due(0)
+    , _delayRead(false)
+{
+}
+
+void DDScenePlayer::start()
+{
+    _position = 0;
+    _due = 0;
+    _delayRead = false;
+    _timer.reset();
+    _timer.start();
+}
+
+bool DDScenePlayer::update()
+{
+    while (true) {
+        if (_position >= _length) {
+            if (!_loop || _length == 0) {
+                return false;
+            }
+            _position = 0;
+        }
+
+        if (!_delayRead) {
+            uint32_t delay;
+            if (!readDelay(&delay)) {
+                _position = _length;
+                return false;
+            }
+            _due += delay;
+            _delayRead = true;
+        }
+        if ((uint32_t) _timer.read_ms() < _due) {
+            return true;
+        }
+
+        uint8_t length = _stream[_position++];
+        if (_position + length > _length) {
+            _position = _length;
+            return false;
+        }
+        const uint8_t *record = _stream + _position;
+        _position += length;
+        _delayRead = false;
+        if (length == 0) {
+            continue;
+        }
+        _booster.sendRawBytes(record, length);
+        if (DDBooster::containsShow(record, length)) {
+            _booster.waitForUpdate();
+        }
+    }
+}
+
+bool DDScenePlayer::readDelay(uint32_t *delay)
+{
+    uint32_t value = 0;
+    for (uint8_t shift = 0; shift < 32; shift += 7) {
+        if (_position >= _length) {
+            return false;
+        }
+        uint8_t b = _stream[_position++];
+        value |= (uint32_t) (b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *delay = value;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,146 @@
+/*
+ * DDScene.h - Scene script compiler and command stream player for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDSCENE_H
+#define DD_BOOSTER_DDSCENE_H
+
+#include "DDBooster.h"
+
+/**
+ * @brief Compiles a scene script into a timed stream of DD-Booster commands.
+ *
+ * The script has one statement per line, '#' starts a comment:
+ *
+ *     leds <count>                        number of LEDs, used to check the indices (default 256)
+ *     rgb <r> <g> <b>                     set the color
+ *     hsv <h> <s> <v>                     set the color in HSV format
+ *     led <index>                         assign the color to one LED
+ *     range <start> <end>                 assign the color to a range of LEDs
+ *     all                                 assign the color to all LEDs
+ *     rainbow <h> <s> <v> <start> <end> <step>
+ *     gradient <start> <end> <r> <g> <b> <r> <g> <b>
+ *     shift up|down <start> <end> <count>
+ *     copy <from> <to>
+ *     repeat <start> <end> <count>
+ *     show
+ *     wait <ms>                           delay the following commands
+ *     loop <count> ... end                repeat the enclosed statements (nested up to 4 levels)
+ *
+ * The output is a sequence of records, one per SPI transaction: the delay to the previous
+ * record in milliseconds (7 bits per byte, least significant first, bit 7 set if more bytes
+ * follow), the length of the transaction and the command bytes. A wait at the end of the
+ * script becomes a record without command bytes, so a looping player keeps the last frame
+ * for that time before it starts again.
+ *
+ * Colors, saturation, brightness, steps and counts are single bytes, values above 255 are
+ * rejected. Hues above 359 are limited to 359.
+ *
+ * While compiling the commands are optimized:
+ * - a color is only sent if a following command uses it and the DD-Booster does not
+ *   have it already
+ * - the color is sent together with the command using it in one transaction
+ * - consecutive LEDs with the same color become one range command
+ */
+class DDSceneCompiler {
+public:
+
+    /**
+     * @param output - Buffer for the command stream
+     * @param capacity - Size of the buffer in bytes
+     */
+    DDSceneCompiler(uint8_t *output, uint32_t capacity);
+
+    /**
+     * Compiles a script. The previous output is replaced.
+     * @param script - Zero terminated script text
+     * @return false on errors, see getError() and getErrorLine()
+     */
+    bool compile(const char *script);
+
+    /**
+     * Returns the length of the compiled stream in bytes.
+     */
+    uint32_t getLength() const;
+
+    /**
+     * Returns the description of the last error or NULL.
+     */
+    const char *getError() const;
+
+    /**
+     * Returns the script line of the last error, starting with 1.
+     */
+    uint16_t getErrorLine() const;
+
+private:
+    bool statement(const char *line, const char *end);
+    bool arguments(const char *&p, const char *end, int32_t *values, uint8_t count);
+    bool checkIndex(int32_t index);
+    bool checkBytes(const int32_t *values, uint8_t count);
+    void useColor(const uint8_t *target, uint8_t length);
+    void command(const uint8_t *bytes, uint8_t length);
+    void record(const uint8_t *bytes, uint8_t length);
+    bool fail(const char *error);
+
+    uint8_t *_output;
+    uint32_t _capacity;
+    uint32_t _length;
+    const char *_error;
+    uint16_t _line;
+    uint16_t _ledCount;
+    uint32_t _delay;
+    uint32_t _lastRecord;
+    uint32_t _lastTarget;
+    bool _lastMergeable;
+    uint8_t _color[5];
+    uint8_t _colorLength;
+    uint8_t _pending[5];
+    uint8_t _pendingLength;
+};
+
+/**
+ * @brief Replays a command stream created by DDSceneCompiler.
+ *
+ * The MCU only sends the stored transactions when their time has come, no effect is
+ * calculated at runtime. After a transaction containing SHOW the player waits until the
+ * LEDs are updated with DDBooster::waitForUpdate(), so deferred delays of the booster apply.
+ */
+class DDScenePlayer {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param stream - Command stream, must stay valid while playing
+     * @param length - Length of the stream in bytes
+     * @param loop - If true the stream restarts at the end
+     */
+    DDScenePlayer(DDBooster &booster, const uint8_t *stream, uint32_t length, bool loop = false);
+
+    /**
+     * Starts playing from the beginning.
+     */
+    void start();
+
+    /**
+     * Sends all transactions which are due. Call it from the main loop.
+     * @return false when the end of a non-looping stream was reached
+     */
+    bool update();
+
+private:
+    bool readDelay(uint32_t *delay);
+
+    DDBooster &_booster;
+    const uint8_t *_stream;
+    uint32_t _length;
+    bool _loop;
+    uint32_t _position;
+    uint32_t _due;
+    bool _delayRead;
+    Timer _timer;
+};
+
+#endif //DD_BOOSTER_DDSCENE_H
@@ -0,0 +1,178 @@
+/*
+ * DDSerialReceiver.cpp - TPM2 and Adalight serial pixel stream receiver for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDSerialReceiver.h"
+
+#define TPM2_START           0xC9
+#define TPM2_TYPE_DATA       0xDA
+#define TPM2_END             0x36
+
+DDSerialReceiver::DDSerialReceiver(DDFrameBuffer &frame, Protocol protocol, uint16_t chunk)
+    : _frame(frame)
+    , _protocol(protocol)
+    , _chunk(chunk ? chunk : 1)
+    , _serial(NULL)
+    , _state(STATE_START)
+    , _size(0)
+    , _received(0)
+    , _sentLeds(0)
+    , _frames(0)
+    , _errors(0)
+    , _lostBytes(0)
+    , _head(0)
+    , _tail(0)
+{
+}
+
+void DDSerialReceiver::attach(RawSerial &serial)
+{
+    _serial = &serial;
+    _serial->attach(callback(this, &DDSerialReceiver::onReceive), RawSerial::RxIrq);
+}
+
+void DDSerialReceiver::onReceive()
+{
+    while (_serial->readable()) {
+        uint8_t byte = _serial->getc();
+        uint16_t next = (_head + 1) % RX_BUFFER_SIZE;
+        if (next == _tail) {
+            // ring buffer full, the byte is lost. Counted separately, _errors is only
+            // changed by the parser in the main context
+            _lostBytes++;
+            continue;
+        }
+        _rxBuffer[_head] = byte;
+        _head = next;
+    }
+}
+
+uint16_t DDSerialReceiver::poll()
+{
+    uint16_t count = 0;
+    while (_tail != _head) {
+        uint8_t byte = _rxBuffer[_tail];
+        _tail = (_tail + 1) % RX_BUFFER_SIZE;
+        feed(byte);
+        count++;
+    }
+    return count;
+}
+
+void DDSerialReceiver::feed(uint8_t byte)
+{
+    switch (_state) {
+    case STATE_START:
+        if (_protocol == PROTOCOL_TPM2 && byte == TPM2_START) {
+            _state = STATE_TYPE;
+        } else if (_protocol == PROTOCOL_ADALIGHT && byte == 'A') {
+            _state = STATE_MAGIC_D;
+        }
+        break;
+
+    case STATE_TYPE:
+        // only data frames are handled, commands are skipped
+        _state = byte == TPM2_TYPE_DATA ? STATE_SIZE_HIGH : STATE_START;
+        break;
+
+    case STATE_MAGIC_D:
+        _state = byte == 'd' ? STATE_MAGIC_A : STATE_START;
+        break;
+
+    case STATE_MAGIC_A:
+        _state = byte == 'a' ? STATE_SIZE_HIGH : STATE_START;
+        break;
+
+    case STATE_SIZE_HIGH:
+        _size = byte << 8;
+        _state = STATE_SIZE_LOW;
+        break;
+
+    case STATE_SIZE_LOW:
+        _size |= byte;
+        if (_protocol == PROTOCOL_ADALIGHT) {
+            _state = STATE_CHECKSUM;
+        } else {
+            beginData();
+        }
+        break;
+
+    case STATE_CHECKSUM:
+        if (byte != ((_size >> 8) ^ (_size & 0xFF) ^ 0x55)) {
+            _errors++;
+            _state = STATE_START;
+            break;
+        }
+        // Adalight sends the number of LEDs minus one
+        _size = (_size + 1) * 3;
+        beginData();
+        break;
+
+    case STATE_DATA: {
+        if (_received < DDFrameBuffer::MAX_LEDS * 3) {
+            _frame.getData()[_received] = byte;
+        }
+        _received++;
+
+        // send each complete chunk while the rest of the frame is arriving
+        uint16_t leds = _received / 3;
+        if (leds - _sentLeds >= _chunk) {
+            _frame.update(_sentLeds, leds - 1);
+            _sentLeds = leds;
+        }
+
+        if (_received >= _size) {
+            if (_protocol == PROTOCOL_TPM2) {
+                _state = STATE_END;
+            } else {
+                endFrame();
+            }
+        }
+        break;
+    }
+
+    case STATE_END:
+        if (byte == TPM2_END) {
+            endFrame();
+        } else {
+            _errors++;
+            _state = STATE_START;
+        }
+        break;
+    }
+}
+
+void DDSerialReceiver::beginData()
+{
+    _received = 0;
+    _sentLeds = 0;
+    _state = _size ? STATE_DATA : STATE_START;
+
+    if (_size && !_frame.isValid()) {
+        // the first chunk would be sent completely and again with the final flush(),
+        // send the previous content once without showing it, afterwards only the changes
+        // are sent and endFrame() shows the new frame
+        _frame.update(0, _frame.getSize() - 1);
+    }
+}
+
+void DDSerialReceiver::endFrame()
+{
+    // only the LEDs after the last chunk are left, flush sends them and shows the frame
+    _frame.flush();
+    _frames++;
+    _state = STATE_START;
+}
+
+uint32_t DDSerialReceiver::getFrameCount() const
+{
+    return _frames;
+}
+
+uint32_t DDSerialReceiver::getErrorCount() const
+{
+    return _errors + _lostBytes;
+}
@@ -0,0 +1,117 @@
+/*
+ * DDSerialReceiver.h - TPM2 and Adalight serial pixel stream receiver for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDSERIALRECEIVER_H
+#define DD_BOOSTER_DDSERIALRECEIVER_H
+
+#include "DDFrameBuffer.h"
+
+/**
+ * @brief Parses a serial pixel stream byte by byte and forwards the pixels while the frame arrives.
+ *
+ * Supported protocols:
+ * - PROTOCOL_TPM2: 0xC9 0xDA size(16 bit) data 0x36
+ * - PROTOCOL_ADALIGHT: 'A' 'd' 'a' count-1(16 bit) checksum data
+ *
+ * The pixel bytes are written directly into the frame buffer. Each time a chunk of LEDs is
+ * complete, its changes are sent to the DD-Booster while the rest of the frame is still
+ * arriving. At the end of the frame only the last chunk and SHOW are left to send, so the
+ * LEDs are updated about one frame time after the frame started instead of two.
+ *
+ * Without a known state of the DD-Booster every chunk would be sent completely and the
+ * final flush() would send the whole frame once more. So if the frame buffer is not valid
+ * when a frame starts, its current content is sent first without SHOW and the chunks only
+ * carry the changes. The LEDs never show the old content again.
+ *
+ * attach() registers a receive interrupt which stores the bytes in a ring buffer, poll()
+ * parses them in the main loop. feed() can be used to pass bytes from any other source, it
+ * must not be called from the interrupt while poll() is used.
+ */
+class DDSerialReceiver {
+public:
+
+    /**
+     * Serial pixel protocol.
+     */
+    enum Protocol {
+        PROTOCOL_TPM2,
+        PROTOCOL_ADALIGHT
+    };
+
+    /**
+     * Size of the receive ring buffer. Must hold the bytes arriving while a chunk is sent.
+     */
+    static const uint16_t RX_BUFFER_SIZE = 1024;
+
+    /**
+     * @param frame - Frame buffer to write the pixels to
+     * @param protocol - Serial pixel protocol
+     * @param chunk - Number of complete LEDs sent together while the frame arrives, 16 is default
+     */
+    DDSerialReceiver(DDFrameBuffer &frame, Protocol protocol, uint16_t chunk = 16);
+
+    /**
+     * Registers the receive interrupt of the serial port.
+     * @param serial - Configured serial port
+     */
+    void attach(RawSerial &serial);
+
+    /**
+     * Parses all bytes received by the interrupt. Call it from the main loop.
+     * @return number of parsed bytes
+     */
+    uint16_t poll();
+
+    /**
+     * Parses one byte of the stream.
+     * @param byte - Next byte of the stream
+     */
+    void feed(uint8_t byte);
+
+    /**
+     * Returns the number of completely received frames.
+     */
+    uint32_t getFrameCount() const;
+
+    /**
+     * Returns the number of frames with protocol errors and lost bytes caused by a full ring buffer.
+     */
+    uint32_t getErrorCount() const;
+
+private:
+    enum State {
+        STATE_START,
+        STATE_TYPE,
+        STATE_MAGIC_D,
+        STATE_MAGIC_A,
+        STATE_SIZE_HIGH,
+        STATE_SIZE_LOW,
+        STATE_CHECKSUM,
+        STATE_DATA,
+        STATE_END
+    };
+
+    void onReceive();
+    void beginData();
+    void endFrame();
+
+    DDFrameBuffer &_frame;
+    Protocol _protocol;
+    uint16_t _chunk;
+    RawSerial *_serial;
+    State _state;
+    uint16_t _size;
+    uint16_t _received;
+    uint16_t _sentLeds;
+    uint32_t _frames;
+    uint32_t _errors;
+    volatile uint32_t _lostBytes;
+    volatile uint16_t _head;
+    volatile uint16_t _tail;
+    uint8_t _rxBuffer[RX_BUFFER_SIZE];
+};
+
+#endif //DD_BOOSTER_DDSERIALRECEIVER_H
@@ -0,0 +1,122 @@
+/*
+ * DDSubmitter.cpp - Thread safe submission of Digi-Dot-Booster commands
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_RTOS_PRESENT
+
+#include "DDSubmitter.h"
+
+DDSubmitter::DDSubmitter(DDBooster &booster)
+    : _booster(booster)
+{
+    memset(&_stats, 0, sizeof (_stats));
+}
+
+DDSubmitter::~DDSubmitter()
+{
+}
+
+void DDSubmitter::send(const uint8_t *data, uint8_t length, uint32_t submitted)
+{
+    _booster.sendRawBytes(data, length);
+    if (DDBooster::containsShow(data, length)) {
+        _booster.waitForUpdate();
+    }
+    uint32_t latency = us_ticker_read() - submitted;
+
+    core_util_critical_section_enter();
+    _stats.transactions++;
+    _stats.latencySum += latency;
+    if (latency > _stats.latencyMax) {
+        _stats.latencyMax = latency;
+    }
+    core_util_critical_section_exit();
+}
+
+uint16_t DDSubmitter::getLedCount() const
+{
+    return _booster.getLedCount();
+}
+
+DDSubmitter::Stats DDSubmitter::getStats() const
+{
+    core_util_critical_section_enter();
+    Stats stats = _stats;
+    core_util_critical_section_exit();
+    return stats;
+}
+
+void DDSubmitter::resetStatistics()
+{
+    core_util_critical_section_enter();
+    memset(&_stats, 0, sizeof (_stats));
+    core_util_critical_section_exit();
+}
+
+DDMutexSubmitter::DDMutexSubmitter(DDBooster &booster)
+    : DDSubmitter(booster)
+{
+}
+
+bool DDMutexSubmitter::submit(const uint8_t *data, uint8_t length)
+{
+    if (length == 0 || length > MAX_LENGTH) {
+        return false;
+    }
+    uint32_t submitted = us_ticker_read();
+    _mutex.lock();
+    send(data, length, submitted);
+    _mutex.unlock();
+    return true;
+}
+
+DDQueueSubmitter::DDQueueSubmitter(DDBooster &booster, uint32_t timeout)
+    : DDSubmitter(booster)
+    , _timeout(timeout)
+{
+}
+
+void DDQueueSubmitter::start(osPriority priority)
+{
+    _thread.start(callback(this, &DDQueueSubmitter::run));
+    _thread.set_priority(priority);
+}
+
+bool DDQueueSubmitter::submit(const uint8_t *data, uint8_t length)
+{
+    if (length == 0 || length > MAX_LENGTH) {
+        return false;
+    }
+    uint32_t submitted = us_ticker_read();
+    // Mail::alloc() does not block, so a full queue is polled each millisecond
+    Transaction *transaction;
+    for (uint32_t waited = 0; (transaction = _queue.alloc()) == NULL; waited++) {
+        if (waited >= _timeout) {
+            return false;
+        }
+        Thread::wait(1);
+    }
+    memcpy(transaction->data, data, length);
+    transaction->length = length;
+    transaction->submitted = submitted;
+    _queue.put(transaction);
+    return true;
+}
+
+void DDQueueSubmitter::run()
+{
+    while (true) {
+        osEvent event = _queue.get();
+        if (event.status != osEventMail) {
+            continue;
+        }
+        Transaction *transaction = (Transaction *) event.value.p;
+        send(transaction->data, transaction->length, transaction->submitted);
+        _queue.free(transaction);
+    }
+}
+
+#endif // MBED_CONF_RTOS_PRESENT
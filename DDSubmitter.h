@@ -0,0 +1,133 @@
+/*
+ * DDSubmitter.h - Thread safe submission of Digi-Dot-Booster commands
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDSUBMITTER_H
+#define DD_BOOSTER_DDSUBMITTER_H
+
+#include "DDBooster.h"
+#include "rtos.h"
+
+/**
+ * @brief Base class for sending commands to one DD-Booster from several threads.
+ *
+ * A transaction is submitted as raw command bytes, like DDBooster::sendRawBytes().
+ * For each transaction the time from the submit() call until it was sent is measured,
+ * for a transaction containing SHOW until the LEDs are updated. With deferred delays of
+ * the booster the LED update is left to the next transaction and not measured.
+ */
+class DDSubmitter {
+public:
+
+    /**
+     * Maximal length of a transaction.
+     */
+    static const uint8_t MAX_LENGTH = 16;
+
+    /**
+     * Latency measurements since the last resetStatistics() call.
+     */
+    struct Stats {
+        uint32_t transactions;
+        uint32_t latencySum;
+        uint32_t latencyMax;
+    };
+
+    DDSubmitter(DDBooster &booster);
+
+    virtual ~DDSubmitter();
+
+    /**
+     * Submits a transaction. Can be called from any thread, but not from an interrupt.
+     * @param data - Command bytes
+     * @param length - Number of bytes (1 - MAX_LENGTH)
+     * @return false if the transaction was not accepted
+     */
+    virtual bool submit(const uint8_t *data, uint8_t length) = 0;
+
+    /**
+     * Returns the number of LEDs of the booster.
+     */
+    uint16_t getLedCount() const;
+
+    /**
+     * Returns the latency measurements.
+     */
+    Stats getStats() const;
+
+    /**
+     * Resets the latency measurements.
+     */
+    void resetStatistics();
+
+protected:
+    void send(const uint8_t *data, uint8_t length, uint32_t submitted);
+
+    DDBooster &_booster;
+    Stats _stats;
+};
+
+/**
+ * @brief Sends the transaction in the calling thread while holding a mutex.
+ *
+ * submit() returns after the command delay, or after the LED update for SHOW. Threads
+ * submitting at the same time wait for each other on the mutex.
+ */
+class DDMutexSubmitter : public DDSubmitter {
+public:
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDMutexSubmitter(DDBooster &booster);
+
+    virtual bool submit(const uint8_t *data, uint8_t length);
+
+private:
+    Mutex _mutex;
+};
+
+/**
+ * @brief Copies the transaction into a queue, a sender thread sends the queued transactions.
+ *
+ * submit() only waits if the queue is full. Call start() once before submitting.
+ */
+class DDQueueSubmitter : public DDSubmitter {
+public:
+
+    /**
+     * Number of transactions the queue can hold.
+     */
+    static const uint8_t QUEUE_SIZE = 32;
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     * @param timeout - Maximal time to wait for space in the queue in milliseconds
+     */
+    DDQueueSubmitter(DDBooster &booster, uint32_t timeout = osWaitForever);
+
+    /**
+     * Starts the sender thread.
+     * @param priority - Priority of the sender thread
+     */
+    void start(osPriority priority = osPriorityAboveNormal);
+
+    virtual bool submit(const uint8_t *data, uint8_t length);
+
+private:
+    struct Transaction {
+        uint8_t data[MAX_LENGTH];
+        uint8_t length;
+        uint32_t submitted;
+    };
+
+    void run();
+
+    Mail<Transaction, QUEUE_SIZE> _queue;
+    Thread _thread;
+    uint32_t _timeout;
+};
+
+#endif //DD_BOOSTER_DDSUBMITTER_H
@@ -0,0 +1,121 @@
+/*
+ * DDTask.cpp - Cooperative effect tasks for driving many Digi-Dot-Boosters from one thread
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDTask.h"
+
+DDTask::DDTask()
+    : _resume(0)
+    , _wakeAt(0)
+{
+}
+
+DDTask::~DDTask()
+{
+}
+
+void DDTask::restart()
+{
+    _resume = 0;
+}
+
+void DDTask::sleepFor(uint32_t ms)
+{
+    _wakeAt = us_ticker_read() + ms * 1000;
+}
+
+bool DDTask::isAwake() const
+{
+    return (int32_t) (us_ticker_read() - _wakeAt) >= 0;
+}
+
+DDTaskScheduler::DDTaskScheduler()
+    : _count(0)
+{
+}
+
+bool DDTaskScheduler::add(DDTask &task)
+{
+    if (_count == MAX_TASKS) {
+        return false;
+    }
+    _tasks[_count++] = &task;
+    return true;
+}
+
+void DDTaskScheduler::remove(DDTask &task)
+{
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_tasks[i] == &task) {
+            _count--;
+            for (; i < _count; i++) {
+                _tasks[i] = _tasks[i + 1];
+            }
+            return;
+        }
+    }
+}
+
+uint8_t DDTaskScheduler::poll()
+{
+    uint8_t i = 0;
+    while (i < _count) {
+        if (_tasks[i]->run()) {
+            i++;
+        } else {
+            remove(*_tasks[i]);
+        }
+    }
+    return _count;
+}
+
+#if defined(__cpp_impl_coroutine)
+
+DDCoroutineTask::DDCoroutineTask(std::coroutine_handle<promise_type> handle)
+    : _handle(handle)
+{
+}
+
+DDCoroutineTask::DDCoroutineTask(DDCoroutineTask &&other)
+    : _handle(other._handle)
+{
+    other._handle = std::coroutine_handle<promise_type>();
+}
+
+DDCoroutineTask::~DDCoroutineTask()
+{
+    if (_handle) {
+        _handle.destroy();
+    }
+}
+
+bool DDCoroutineTask::run()
+{
+    if (!_handle || _handle.done()) {
+        return false;
+    }
+
+    // waiting tasks are only checked, not resumed
+    promise_type &promise = _handle.promise();
+    if (promise.booster && !promise.booster->isReady()) {
+        return true;
+    }
+    if (promise.sleeping && (int32_t) (us_ticker_read() - promise.wakeAt) < 0) {
+        return true;
+    }
+    promise.booster = NULL;
+    promise.sleeping = false;
+
+    _handle.resume();
+    return !_handle.done();
+}
+
+uint32_t DDCoroutineTask::getFrame() const
+{
+    return _handle ? _handle.promise().frame : 0;
+}
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,325 @@
+/*
+ * DDTask.h - Cooperative effect tasks for driving many Digi-Dot-Boosters from one thread
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDTASK_H
+#define DD_BOOSTER_DDTASK_H
+
+#include "DDBooster.h"
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+/**
+ * Starts the body of DDTask::run().
+ */
+#define DD_TASK_BEGIN() switch (_resume) { case 0:
+
+/**
+ * Suspends the task until the condition is true.
+ */
+#define DD_TASK_AWAIT(condition) DD_TASK_AWAIT_AT(__COUNTER__ + 1, condition)
+
+/**
+ * Suspends the task until the DD-Booster is ready for the next command.
+ */
+#define DD_TASK_AWAIT_READY(booster) DD_TASK_AWAIT((booster).isReady())
+
+/**
+ * Suspends the task until the next run, e.g. after a frame.
+ */
+#define DD_TASK_YIELD() DD_TASK_YIELD_AT(__COUNTER__ + 1)
+
+/**
+ * Suspends the task for a number of milliseconds.
+ */
+#define DD_TASK_SLEEP(ms) \
+    do { sleepFor(ms); DD_TASK_AWAIT(isAwake()); } while (0)
+
+/**
+ * Ends the body of DDTask::run(), the task is finished.
+ */
+#define DD_TASK_END() } _resume = 0; return false
+
+// The case labels of the macros are reached from the code before them, they are marked for
+// -Wimplicit-fallthrough.
+#if __cplusplus >= 201703L
+#define DD_TASK_FALLTHROUGH [[fallthrough]]
+#elif defined(__has_attribute)
+#if __has_attribute(fallthrough)
+#define DD_TASK_FALLTHROUGH __attribute__((fallthrough))
+#endif
+#endif
+#ifndef DD_TASK_FALLTHROUGH
+#define DD_TASK_FALLTHROUGH
+#endif
+
+// The resume points are numbered with __COUNTER__, the argument is expanded once before it
+// is used twice, so several macros may share a line.
+#define DD_TASK_AWAIT_AT(id, condition) \
+    do { _resume = id; DD_TASK_FALLTHROUGH; case id: if (!(condition)) return true; } while (0)
+#define DD_TASK_YIELD_AT(id) \
+    do { _resume = id; return true; DD_TASK_FALLTHROUGH; case id:; } while (0)
+
+/**
+ * @brief Base class of effects written as cooperative tasks.
+ *
+ * A task is a function which can suspend itself while the DD-Booster processes a command or
+ * updates the LEDs, and continues at the same place on the next run. The DD-Booster has to be
+ * set to deferred delays (DDBooster::setDeferredDelays()), so the commands return without
+ * waiting. One thread can drive the effects of many DD-Boosters with DDTaskScheduler, no
+ * thread per strip is needed.
+ *
+ * The body of run() is written between DD_TASK_BEGIN() and DD_TASK_END() and suspends with
+ * the DD_TASK_* macros. The macros are based on a switch statement: local variables lose
+ * their values when the task is suspended, use member variables instead, and the macros
+ * cannot be used inside another switch statement.
+ *
+ *     class Chase : public DDTask {
+ *     public:
+ *         Chase(DDBooster &booster) : _booster(booster) {}
+ *         virtual bool run() {
+ *             DD_TASK_BEGIN();
+ *             for (_i = 0; _i < 60; _i++) {
+ *                 DD_TASK_AWAIT_READY(_booster);
+ *                 _booster.setLED(_i, 255, 0, 0);
+ *                 DD_TASK_AWAIT_READY(_booster);
+ *                 _booster.show();
+ *                 DD_TASK_SLEEP(20);
+ *             }
+ *             DD_TASK_END();
+ *         }
+ *     private:
+ *         DDBooster &_booster;
+ *         uint8_t _i;
+ *     };
+ */
+class DDTask {
+public:
+
+    DDTask();
+
+    virtual ~DDTask();
+
+    /**
+     * Runs the task until it suspends or ends.
+     * @return false when the task is finished
+     */
+    virtual bool run() = 0;
+
+    /**
+     * Starts the task from the beginning on the next run.
+     */
+    void restart();
+
+protected:
+    void sleepFor(uint32_t ms);
+    bool isAwake() const;
+
+    int _resume;
+    uint32_t _wakeAt;
+};
+
+/**
+ * @brief Runs many tasks in one thread, round robin.
+ */
+class DDTaskScheduler {
+public:
+
+    /**
+     * Maximal number of tasks.
+     */
+    static const uint8_t MAX_TASKS = 32;
+
+    DDTaskScheduler();
+
+    /**
+     * Adds a task. The task is not copied and must stay valid while it is scheduled.
+     * @param task - Task to run
+     * @return false if MAX_TASKS are already scheduled
+     */
+    bool add(DDTask &task);
+
+    /**
+     * Removes a task.
+     * @param task - Previously added task
+     */
+    void remove(DDTask &task);
+
+    /**
+     * Runs each task once until it suspends. Finished tasks are removed.
+     * Call it from the main loop.
+     * @return number of scheduled tasks
+     */
+    uint8_t poll();
+
+private:
+    DDTask *_tasks[MAX_TASKS];
+    uint8_t _count;
+};
+
+#if defined(__cpp_impl_coroutine)
+
+/**
+ * @brief Effect task written as a C++20 coroutine, for host builds with a C++20 compiler.
+ *
+ * A function returning DDCoroutineTask is a coroutine. It suspends with
+ * co_await DDReady(booster) until the DD-Booster is ready for the next command, with
+ * co_await DDSleep(ms) for a number of milliseconds and with co_yield after each frame.
+ * Local variables keep their values and there is no restriction on switch statements.
+ * The task is added to a DDTaskScheduler like any other DDTask, a waiting task is only
+ * checked and not resumed until the DD-Booster is ready or the sleep time has passed.
+ *
+ *     DDCoroutineTask chase(DDBooster &booster) {
+ *         for (uint32_t frame = 0; ; frame++) {
+ *             for (uint8_t i = 0; i < 60; i++) {
+ *                 co_await DDReady(booster);
+ *                 booster.setLED(i, 255, 0, 0);
+ *                 co_await DDReady(booster);
+ *                 booster.show();
+ *                 co_yield frame;
+ *                 co_await DDSleep(20);
+ *             }
+ *         }
+ *     }
+ *
+ *     DDCoroutineTask task = chase(booster);
+ *     scheduler.add(task);
+ *
+ * The coroutine state is allocated on the heap by the compiler, which is why this variant
+ * is only provided when the compiler supports coroutines, i.e. on PC hosts. restart() has no
+ * effect, a coroutine cannot be started again.
+ */
+class DDCoroutineTask : public DDTask {
+public:
+
+    struct promise_type {
+        DDBooster *booster;
+        uint32_t wakeAt;
+        bool sleeping;
+        uint32_t frame;
+
+        promise_type()
+            : booster(NULL)
+            , wakeAt(0)
+            , sleeping(false)
+            , frame(0)
+        {
+        }
+
+        DDCoroutineTask get_return_object()
+        {
+            return DDCoroutineTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return std::suspend_always();
+        }
+
+        std::suspend_always final_suspend() noexcept
+        {
+            return std::suspend_always();
+        }
+
+        std::suspend_always yield_value(uint32_t value)
+        {
+            frame = value;
+            return std::suspend_always();
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception()
+        {
+        }
+    };
+
+    DDCoroutineTask(DDCoroutineTask &&other);
+
+    virtual ~DDCoroutineTask();
+
+    /**
+     * Resumes the coroutine if it does not wait for the DD-Booster or a sleep.
+     * @return false when the coroutine has returned
+     */
+    virtual bool run();
+
+    /**
+     * Returns the value of the last co_yield, e.g. the number of the last frame.
+     */
+    uint32_t getFrame() const;
+
+private:
+    explicit DDCoroutineTask(std::coroutine_handle<promise_type> handle);
+    DDCoroutineTask(const DDCoroutineTask &);
+    DDCoroutineTask &operator=(const DDCoroutineTask &);
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * @brief Suspends a DDCoroutineTask until the DD-Booster is ready for the next command.
+ */
+class DDReady {
+public:
+    explicit DDReady(DDBooster &booster)
+        : _booster(booster)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return _booster.isReady();
+    }
+
+    void await_suspend(std::coroutine_handle<DDCoroutineTask::promise_type> handle) const
+    {
+        handle.promise().booster = &_booster;
+    }
+
+    void await_resume() const
+    {
+    }
+
+private:
+    DDBooster &_booster;
+};
+
+/**
+ * @brief Suspends a DDCoroutineTask for a number of milliseconds.
+ */
+class DDSleep {
+public:
+    explicit DDSleep(uint32_t ms)
+        : _wakeAt(us_ticker_read() + ms * 1000)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<DDCoroutineTask::promise_type> handle) const
+    {
+        handle.promise().wakeAt = _wakeAt;
+        handle.promise().sleeping = true;
+    }
+
+    void await_resume() const
+    {
+    }
+
+private:
+    uint32_t _wakeAt;
+};
+
+#endif // __cpp_impl_coroutine
+
+#endif //DD_BOOSTER_DDTASK_H
@@ -0,0 +1,109 @@
+/*
+ * DDTimecodePlayer.cpp - Show playback following an external timecode
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDTimecodePlayer.h"
+
+// clock rate in 1/65536, 65536 is real time
+#define TIMECODE_RATE_ONE    65536
+
+// the speed correction would remove the clock difference within this time in microseconds,
+// it is limited to MAX_SLEW_PERMILLE, so only differences up to 50 ms are removed that fast
+#define TIMECODE_SLEW_TIME   1000000
+
+DDTimecodePlayer::DDTimecodePlayer(Callback<void(uint32_t)> render, uint16_t frameRate)
+    : _render(render)
+    , _framePeriod(1000000 / (frameRate ? frameRate : 1))
+    , _running(false)
+    , _rendered(false)
+    , _base(0)
+    , _rate(TIMECODE_RATE_ONE)
+    , _lastError(0)
+    , _lastFrame(0)
+    , _dropped(0)
+{
+}
+
+uint64_t DDTimecodePlayer::localTime()
+{
+    return _base + ((int64_t) _timer.read_us() * _rate / TIMECODE_RATE_ONE);
+}
+
+void DDTimecodePlayer::receiveTimecode(uint32_t showTime)
+{
+    uint64_t remote = (uint64_t) showTime * 1000;
+
+    if (!_running) {
+        _base = remote;
+        _rate = TIMECODE_RATE_ONE;
+        _timer.reset();
+        _timer.start();
+        _running = true;
+        return;
+    }
+
+    // continue from the current local time with a new rate
+    uint64_t local = localTime();
+    _base = local;
+    _timer.reset();
+
+    int64_t error = (int64_t) remote - (int64_t) local;
+    _lastError = error;
+
+    if (error > JUMP_THRESHOLD * 1000 || error < -JUMP_THRESHOLD * 1000) {
+        _base = remote;
+        _rate = TIMECODE_RATE_ONE;
+        // render the frame at the new position, no matter in which direction it jumped
+        _rendered = false;
+        return;
+    }
+
+    // run faster or slower to remove the difference within the slew time
+    int64_t correction = error * TIMECODE_RATE_ONE / TIMECODE_SLEW_TIME;
+    int64_t limit = (int64_t) TIMECODE_RATE_ONE * MAX_SLEW_PERMILLE / 1000;
+    if (correction > limit) {
+        correction = limit;
+    } else if (correction < -limit) {
+        correction = -limit;
+    }
+    _rate = TIMECODE_RATE_ONE + correction;
+}
+
+bool DDTimecodePlayer::update()
+{
+    if (!_running) {
+        return false;
+    }
+
+    uint32_t frame = localTime() / _framePeriod;
+
+    if (_rendered && frame == _lastFrame) {
+        return false;
+    }
+    if (_rendered && frame > _lastFrame + 1) {
+        _dropped += frame - _lastFrame - 1;
+    }
+
+    _lastFrame = frame;
+    _rendered = true;
+    _render(frame);
+    return true;
+}
+
+uint32_t DDTimecodePlayer::getShowTime()
+{
+    return _running ? localTime() / 1000 : 0;
+}
+
+int64_t DDTimecodePlayer::getLastError() const
+{
+    return _lastError;
+}
+
+uint32_t DDTimecodePlayer::getDroppedFrames() const
+{
+    return _dropped;
+}
@@ -0,0 +1,94 @@
+/*
+ * DDTimecodePlayer.h - Show playback following an external timecode
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDTIMECODEPLAYER_H
+#define DD_BOOSTER_DDTIMECODEPLAYER_H
+
+#include <mbed.h>
+
+/**
+ * @brief Plays show frames in sync with an external timecode.
+ *
+ * Between two timecodes a local clock keeps running. Each received timecode is compared
+ * with the local clock: small differences are corrected by running the local clock slightly
+ * faster or slower, large differences (above JUMP_THRESHOLD) by jumping to the timecode.
+ * The speed correction is proportional to the difference, it would remove the difference
+ * within about one second, but it is limited to MAX_SLEW_PERMILLE. So a difference above
+ * 50 ms shrinks by at most 50 ms per second, 500 ms take about 10 s. A timecode source
+ * running faster or slower than the local clock by n/1000 leaves a difference of about n ms,
+ * above MAX_SLEW_PERMILLE it is only followed by jumps.
+ * This way several controllers following the same timecode stay within one frame period
+ * without visible jumps.
+ *
+ * update() renders the frame belonging to the local show time. If the controller fell
+ * behind, the frames in between are dropped instead of being played late. The slewed clock
+ * never runs backwards, after a jump the frame at the new position is rendered right away
+ * in both directions.
+ *
+ * The timecode can come from any source, e.g. DDArtNetReceiver::attachTimecode().
+ */
+class DDTimecodePlayer {
+public:
+
+    /**
+     * Maximal clock speed correction in 1/1000.
+     */
+    static const uint16_t MAX_SLEW_PERMILLE = 50;
+
+    /**
+     * Differences larger than this are corrected by a jump, in milliseconds.
+     */
+    static const uint16_t JUMP_THRESHOLD = 500;
+
+    /**
+     * @param render - Called with the show frame index which has to be displayed
+     * @param frameRate - Show frames per second
+     */
+    DDTimecodePlayer(Callback<void(uint32_t)> render, uint16_t frameRate);
+
+    /**
+     * Passes a received timecode.
+     * @param showTime - Show time in milliseconds
+     */
+    void receiveTimecode(uint32_t showTime);
+
+    /**
+     * Renders the current show frame if it changed. Call it from the main loop.
+     * @return true if a frame was rendered
+     */
+    bool update();
+
+    /**
+     * Returns the local show time in milliseconds.
+     */
+    uint32_t getShowTime();
+
+    /**
+     * Returns the difference between the last timecode and the local clock in microseconds.
+     */
+    int64_t getLastError() const;
+
+    /**
+     * Returns the number of frames skipped because the controller fell behind.
+     */
+    uint32_t getDroppedFrames() const;
+
+private:
+    uint64_t localTime();
+
+    Callback<void(uint32_t)> _render;
+    uint32_t _framePeriod;
+    bool _running;
+    bool _rendered;
+    uint64_t _base;
+    int32_t _rate;
+    int64_t _lastError;
+    uint32_t _lastFrame;
+    uint32_t _dropped;
+    Timer _timer;
+};
+
+#endif //DD_BOOSTER_DDTIMECODEPLAYER_H
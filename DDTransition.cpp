@@ -0,0 +1,138 @@
+/*
+ * DDTransition.cpp - Transitions between two frames for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDTransition.h"
+
+static uint16_t gcd(uint16_t a, uint16_t b)
+{
+    while (b) {
+        uint16_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+DDTransition::DDTransition(DDFrameBuffer &frame)
+    : _frame(frame)
+    , _type(TRANSITION_CROSSFADE)
+    , _easing(EASE_LINEAR)
+    , _duration(0)
+    , _elapsed(0)
+    , _running(false)
+    , _size(0)
+    , _done(0)
+    , _stride(1)
+    , _changedCount(0)
+{
+}
+
+void DDTransition::begin(const uint8_t *to, Type type, uint32_t duration, Easing easing)
+{
+    _type = type;
+    _easing = easing;
+    _duration = duration;
+    _elapsed = 0;
+    _done = 0;
+    _size = _frame.getSize();
+
+    memcpy(_from, _frame.getData(), _size * 3);
+    memcpy(_to, to, _size * 3);
+
+    // LEDs with equal endpoints are never touched
+    _changedCount = 0;
+    for (uint16_t i = 0; i < _size; i++) {
+        if (memcmp(_from + i * 3, _to + i * 3, 3) != 0) {
+            _changed[_changedCount++] = i;
+        }
+    }
+
+    // a stride without common divisor visits every changed LED once in a scattered order
+    _stride = _changedCount * 5 / 8 + 1;
+    while (_changedCount > 1 && gcd(_stride, _changedCount) != 1) {
+        _stride++;
+    }
+
+    _running = _changedCount > 0;
+}
+
+bool DDTransition::update(uint32_t elapsedMs)
+{
+    if (!_running) {
+        return false;
+    }
+
+    _elapsed += elapsedMs;
+    uint16_t t = getProgress();
+
+    if (t >= 256) {
+        memcpy(_frame.getData(), _to, _size * 3);
+        _frame.flush();
+        _running = false;
+        return false;
+    }
+
+    switch (_type) {
+    case TRANSITION_CROSSFADE:
+        for (uint16_t n = 0; n < _changedCount; n++) {
+            uint16_t k = _changed[n] * 3;
+            uint8_t *px = _frame.getData() + k;
+            for (uint8_t c = 0; c < 3; c++) {
+                px[c] = _from[k + c] + ((_to[k + c] - _from[k + c]) * t >> 8);
+            }
+        }
+        break;
+
+    case TRANSITION_WIPE: {
+        // only LEDs passed by the boundary since the last frame change
+        uint16_t boundary = _size * t >> 8;
+        for (; _done < boundary; _done++) {
+            setTarget(_done);
+        }
+        break;
+    }
+
+    case TRANSITION_DISSOLVE: {
+        uint16_t revealed = _changedCount * t >> 8;
+        for (; _done < revealed; _done++) {
+            setTarget(_changed[dissolveIndex(_done)]);
+        }
+        break;
+    }
+    }
+
+    _frame.flush();
+    return true;
+}
+
+bool DDTransition::isRunning() const
+{
+    return _running;
+}
+
+uint16_t DDTransition::getProgress() const
+{
+    if (_duration == 0 || _elapsed >= _duration) {
+        return 256;
+    }
+    uint32_t t = _elapsed * 256 / _duration;
+    if (_easing == EASE_IN_OUT) {
+        // smoothstep 3t^2 - 2t^3
+        t = (t * t * (768 - 2 * t)) >> 16;
+    }
+    return t;
+}
+
+uint16_t DDTransition::dissolveIndex(uint16_t n) const
+{
+    return (uint32_t) n * _stride % _changedCount;
+}
+
+void DDTransition::setTarget(uint16_t index)
+{
+    memcpy(_frame.getData() + index * 3, _to + index * 3, 3);
+}
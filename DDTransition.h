@@ -0,0 +1,91 @@
+/*
+ * DDTransition.h - Transitions between two frames for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDTRANSITION_H
+#define DD_BOOSTER_DDTRANSITION_H
+
+#include "DDFrameBuffer.h"
+
+/**
+ * @brief Animates the change from the current frame to a new one.
+ *
+ * begin() caches the current frame of the frame buffer and the target frame, and collects
+ * the LEDs which differ between them. Only these LEDs are touched during the transition.
+ * Every update() writes the intermediate frame into the frame buffer and flushes it, so
+ * only changed LEDs are sent and equal neighbours are combined to ranges:
+ * - TRANSITION_CROSSFADE blends all differing LEDs in fixed point
+ * - TRANSITION_WIPE moves a boundary from LED 0 to the end, only the LEDs passed by the
+ *   boundary since the last frame change. A target with large areas of one color costs a
+ *   few setRange commands per frame.
+ * - TRANSITION_DISSOLVE switches the LEDs to the target color in a scattered order
+ */
+class DDTransition {
+public:
+
+    /**
+     * Kind of the transition.
+     */
+    enum Type {
+        TRANSITION_CROSSFADE,
+        TRANSITION_WIPE,
+        TRANSITION_DISSOLVE
+    };
+
+    /**
+     * Progress curve of the transition.
+     */
+    enum Easing {
+        EASE_LINEAR,
+        EASE_IN_OUT
+    };
+
+    /**
+     * @param frame - Frame buffer containing the current frame
+     */
+    DDTransition(DDFrameBuffer &frame);
+
+    /**
+     * Starts a transition from the current frame buffer content to the target frame.
+     * @param to - Target frame as RGB triplets, one for each LED of the frame buffer. It is copied
+     * @param type - Kind of the transition
+     * @param duration - Duration in milliseconds
+     * @param easing - Progress curve, EASE_LINEAR is default
+     */
+    void begin(const uint8_t *to, Type type, uint32_t duration, Easing easing = EASE_LINEAR);
+
+    /**
+     * Advances the transition and flushes the frame buffer.
+     * @param elapsedMs - Time elapsed since the last call in milliseconds
+     * @return true while the transition is running, false after the target frame was sent
+     */
+    bool update(uint32_t elapsedMs);
+
+    /**
+     * Returns true while a transition is running.
+     */
+    bool isRunning() const;
+
+private:
+    uint16_t getProgress() const;
+    uint16_t dissolveIndex(uint16_t n) const;
+    void setTarget(uint16_t index);
+
+    DDFrameBuffer &_frame;
+    Type _type;
+    Easing _easing;
+    uint32_t _duration;
+    uint32_t _elapsed;
+    bool _running;
+    uint16_t _size;
+    uint16_t _done;
+    uint16_t _stride;
+    uint16_t _changedCount;
+    uint8_t _changed[DDFrameBuffer::MAX_LEDS];
+    uint8_t _from[DDFrameBuffer::MAX_LEDS * 3];
+    uint8_t _to[DDFrameBuffer::MAX_LEDS * 3];
+};
+
+#endif //DD_BOOSTER_DDTRANSITION_H
@@ -0,0 +1,142 @@
+/*
+ * DDVideoMapper.cpp - Maps video frames onto LED positions for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDVideoMapper.h"
+
+DDVideoMapper::DDVideoMapper(DDSampleWindow *table, uint16_t capacity)
+    : _table(table)
+    , _capacity(capacity)
+    , _count(0)
+    , _sampleWidth(2048)
+    , _sampleHeight(2048)
+    , _stride(0)
+    , _mapTime(0)
+{
+}
+
+void DDVideoMapper::setSampleSize(uint16_t width, uint16_t height)
+{
+    _sampleWidth = width;
+    _sampleHeight = height;
+}
+
+bool DDVideoMapper::addLed(DDFrameBuffer &frame, uint16_t led, uint16_t u, uint16_t v)
+{
+    if (_count >= _capacity) {
+        return false;
+    }
+    DDSampleWindow &w = _table[_count++];
+    memset(&w, 0, sizeof (w));
+    w.frame = &frame;
+    w.led = led;
+    w.u = u;
+    w.v = v;
+    return true;
+}
+
+void DDVideoMapper::build(uint16_t width, uint16_t height, uint32_t stride)
+{
+    _stride = stride ? stride : width * 3;
+
+    for (uint16_t i = 0; i < _count; i++) {
+        DDSampleWindow &w = _table[i];
+        uint8_t columns = buildAxis(w.u, _sampleWidth, width, w.columnOffset, w.columnWeight);
+        w.rows = buildAxis(w.v, _sampleHeight, height, w.rowIndex, w.rowWeight);
+        for (uint8_t c = 0; c < MAX_SAMPLES; c++) {
+            w.columnOffset[c] = c < columns ? w.columnOffset[c] * 3 : w.columnOffset[0];
+        }
+    }
+}
+
+uint8_t DDVideoMapper::buildAxis(uint16_t position, uint16_t sampleSize, uint16_t size, uint16_t *pixels, uint8_t *weights)
+{
+    // window edges in 1/256 pixels, clipped to the image
+    int32_t limit = (int32_t) size << 8;
+    int32_t center = (uint32_t) position * size >> 8;
+    int32_t half = (uint32_t) sampleSize * size >> 9;
+    if (half < 128) {
+        // at least one pixel
+        half = 128;
+    }
+    int32_t start = center - half < 0 ? 0 : center - half;
+    int32_t end = center + half > limit ? limit : center + half;
+    int32_t length = end - start;
+
+    int32_t first = start >> 8;
+    int32_t last = (end - 1) >> 8;
+    uint8_t count = last - first + 1 > MAX_SAMPLES ? MAX_SAMPLES : last - first + 1;
+
+    uint16_t sum = 0;
+    uint8_t largest = 0;
+    for (uint8_t k = 0; k < count; k++) {
+        int32_t cellStart, cellEnd;
+        if (count == last - first + 1) {
+            // every pixel, weighted by the part inside the window
+            int32_t pixel = first + k;
+            cellStart = pixel << 8 < start ? start : pixel << 8;
+            cellEnd = (pixel + 1) << 8 > end ? end : (pixel + 1) << 8;
+            pixels[k] = pixel;
+        } else {
+            // cells of equal size, sampled at their centers
+            cellStart = start + length * k / count;
+            cellEnd = start + length * (k + 1) / count;
+            pixels[k] = (cellStart + cellEnd) >> 9;
+        }
+        weights[k] = (cellEnd - cellStart) * 128 / length;
+        sum += weights[k];
+        if (weights[k] > weights[largest]) {
+            largest = k;
+        }
+    }
+    // the rounding error goes to the largest weight, the sum is exactly 128
+    weights[largest] += 128 - sum;
+
+    for (uint8_t k = count; k < MAX_SAMPLES; k++) {
+        pixels[k] = pixels[0];
+        weights[k] = 0;
+    }
+    return count;
+}
+
+void DDVideoMapper::map(const uint8_t *image)
+{
+    _timer.reset();
+    _timer.start();
+
+    for (uint16_t i = 0; i < _count; i++) {
+        const DDSampleWindow &w = _table[i];
+        uint32_t r = 0, g = 0, b = 0;
+
+        for (uint8_t y = 0; y < w.rows; y++) {
+            const uint8_t *row = image + w.rowIndex[y] * _stride;
+            uint16_t rowR = 0, rowG = 0, rowB = 0;
+
+            // fixed trip count, unused columns have the weight 0
+            for (uint8_t x = 0; x < MAX_SAMPLES; x++) {
+                const uint8_t *px = row + w.columnOffset[x];
+                uint8_t weight = w.columnWeight[x];
+                rowR += px[0] * weight;
+                rowG += px[1] * weight;
+                rowB += px[2] * weight;
+            }
+            r += rowR * w.rowWeight[y];
+            g += rowG * w.rowWeight[y];
+            b += rowB * w.rowWeight[y];
+        }
+
+        // both weight sums are 128
+        w.frame->setPixel(w.led, (r + 8192) >> 14, (g + 8192) >> 14, (b + 8192) >> 14);
+    }
+
+    _timer.stop();
+    _mapTime = _timer.read_us();
+}
+
+uint32_t DDVideoMapper::getMapTime() const
+{
+    return _mapTime;
+}
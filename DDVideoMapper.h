@@ -0,0 +1,119 @@
+/*
+ * DDVideoMapper.h - Maps video frames onto LED positions for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDVIDEOMAPPER_H
+#define DD_BOOSTER_DDVIDEOMAPPER_H
+
+#include "DDFrameBuffer.h"
+
+/**
+ * Maximal number of sample columns and rows per LED.
+ */
+#define DD_VIDEO_MAX_SAMPLES 8
+
+/**
+ * @brief Precomputed sampling window of one LED, about 56 bytes.
+ *
+ * The window is separable: each sample column has a byte offset within the image row and
+ * a weight, each sample row a row index and a weight. The weights of each direction sum up
+ * to 128. Unused columns have the weight 0.
+ */
+struct DDSampleWindow {
+    DDFrameBuffer *frame;
+    uint16_t led;
+    uint16_t u;
+    uint16_t v;
+    uint8_t rows;
+    uint16_t columnOffset[DD_VIDEO_MAX_SAMPLES];
+    uint16_t rowIndex[DD_VIDEO_MAX_SAMPLES];
+    uint8_t columnWeight[DD_VIDEO_MAX_SAMPLES];
+    uint8_t rowWeight[DD_VIDEO_MAX_SAMPLES];
+};
+
+/**
+ * @brief Samples the area around each LED position of a raw RGB image.
+ *
+ * The LED positions are given in coordinates relative to the image size, so a layout works
+ * with any source resolution. build() converts them once into area weight tables for the
+ * current resolution. map() only multiplies and sums the pixels listed in the tables, no
+ * coordinates or divisions are calculated per frame.
+ *
+ * The weights are the area each sample covers. A window covering up to MAX_SAMPLES pixels
+ * in a direction samples every pixel, weighted by the part of it inside the window, which is
+ * an exact box filter with subpixel edges. A larger window is split into MAX_SAMPLES cells
+ * of equal size, each sampled at its center pixel with the area of the cell as weight. So
+ * the cost per frame depends on the number of LEDs and not on the source resolution.
+ *
+ * The column loop always runs over MAX_SAMPLES entries, unused ones with the weight 0, so it
+ * has no branches and is unrolled by the compiler.
+ *
+ * The sampled colors are written into the frame buffers, call flush() of each frame buffer
+ * afterwards to send the changes. The window table is provided by the caller.
+ */
+class DDVideoMapper {
+public:
+
+    /**
+     * Maximal number of samples per window in each direction.
+     */
+    static const uint8_t MAX_SAMPLES = DD_VIDEO_MAX_SAMPLES;
+
+    /**
+     * @param table - Storage for the sampling windows, one per LED
+     * @param capacity - Number of entries in the table
+     */
+    DDVideoMapper(DDSampleWindow *table, uint16_t capacity);
+
+    /**
+     * Sets the size of the sampled area around each LED.
+     * @param width - Width relative to the image width in 1/65536
+     * @param height - Height relative to the image height in 1/65536
+     */
+    void setSampleSize(uint16_t width, uint16_t height);
+
+    /**
+     * Adds a LED at a position of the image. Call build() after the layout is complete.
+     * @param frame - Frame buffer of the LED
+     * @param led - Index of the LED in the frame buffer
+     * @param u - Horizontal position of the LED center relative to the image width in 1/65536
+     * @param v - Vertical position of the LED center relative to the image height in 1/65536
+     * @return false if the table is full
+     */
+    bool addLed(DDFrameBuffer &frame, uint16_t led, uint16_t u, uint16_t v);
+
+    /**
+     * Calculates the sampling windows for a source resolution.
+     * @param width - Image width in pixels, up to 21845
+     * @param height - Image height in pixels
+     * @param stride - Bytes per image row, 0 for width * 3
+     */
+    void build(uint16_t width, uint16_t height, uint32_t stride = 0);
+
+    /**
+     * Samples an image and writes the colors into the frame buffers.
+     * @param image - RGB image with the resolution given to build()
+     */
+    void map(const uint8_t *image);
+
+    /**
+     * Returns the time in microseconds the last map() call took.
+     */
+    uint32_t getMapTime() const;
+
+private:
+    static uint8_t buildAxis(uint16_t position, uint16_t sampleSize, uint16_t size, uint16_t *pixels, uint8_t *weights);
+
+    DDSampleWindow *_table;
+    uint16_t _capacity;
+    uint16_t _count;
+    uint16_t _sampleWidth;
+    uint16_t _sampleHeight;
+    uint32_t _stride;
+    uint32_t _mapTime;
+    Timer _timer;
+};
+
+#endif //DD_BOOSTER_DDVIDEOMAPPER_H
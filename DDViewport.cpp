@@ -0,0 +1,124 @@
+/*
+ * DDViewport.cpp - Scrolling viewport over a virtual canvas for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDViewport.h"
+
+// one pixel in units of the speed accumulator (1/256 pixel * ms)
+#define VIEWPORT_PIXEL_UNIT  (256 * 1000)
+
+static const uint8_t BLACK[3] = {0, 0, 0};
+
+DDViewport::DDViewport(DDBooster &booster, const uint8_t *canvas, uint16_t length, bool wrap)
+    : _booster(booster)
+    , _canvas(canvas)
+    , _length(length)
+    , _wrap(wrap)
+    , _position(0)
+    , _speed(0)
+    , _remainder(0)
+{
+}
+
+void DDViewport::setSpeed(int32_t speed)
+{
+    _speed = speed;
+}
+
+bool DDViewport::update(uint32_t elapsedMs)
+{
+    _remainder += _speed * (int32_t) elapsedMs;
+    int32_t steps = _remainder / VIEWPORT_PIXEL_UNIT;
+    if (steps == 0) {
+        return false;
+    }
+    _remainder -= steps * VIEWPORT_PIXEL_UNIT;
+    scrollBy(steps);
+    _booster.show();
+    return true;
+}
+
+void DDViewport::scrollBy(int32_t count)
+{
+    uint16_t ledCount = _booster.getLedCount();
+    uint8_t last = ledCount - 1;
+
+    if (count == 0) {
+        return;
+    }
+    if (count >= ledCount || -count >= ledCount) {
+        moveTo(_position + count);
+        return;
+    }
+
+    _position += count;
+    if (_wrap && _length > 0) {
+        _position %= _length;
+    }
+
+    if (count > 0) {
+        // content moves towards LED 0, new pixels appear at the end
+        _booster.shiftDown(0, last, count);
+        draw(ledCount - count, last);
+    } else {
+        _booster.shiftUp(0, last, -count);
+        draw(0, -count - 1);
+    }
+}
+
+void DDViewport::moveTo(int32_t position)
+{
+    _position = position;
+    if (_wrap && _length > 0) {
+        _position %= _length;
+    }
+    redraw();
+}
+
+void DDViewport::redraw()
+{
+    draw(0, _booster.getLedCount() - 1);
+}
+
+int32_t DDViewport::getPosition() const
+{
+    return _position;
+}
+
+const uint8_t *DDViewport::pixel(int32_t position) const
+{
+    if (_length == 0) {
+        return BLACK;
+    }
+    if (_wrap) {
+        position %= _length;
+        if (position < 0) {
+            position += _length;
+        }
+    } else if (position < 0 || position >= _length) {
+        return BLACK;
+    }
+    return _canvas + position * 3;
+}
+
+void DDViewport::draw(uint16_t first, uint16_t last)
+{
+    // pixels with the same color are combined to one range command
+    uint16_t start = first;
+    while (start <= last) {
+        const uint8_t *color = pixel(_position + start);
+        uint16_t end = start;
+        while (end < last && memcmp(pixel(_position + end + 1), color, 3) == 0) {
+            end++;
+        }
+        if (start == end) {
+            _booster.setLED(start, color[0], color[1], color[2]);
+        } else {
+            _booster.setRange(start, end, color[0], color[1], color[2]);
+        }
+        start = end + 1;
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * DDViewport.h - Scrolling viewport over a virtual canvas for the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDVIEWPORT_H
+#define DD_BOOSTER_DDVIEWPORT_H
+
+#include "DDBooster.h"
+
+/**
+ * @brief Shows a window of a virtual canvas which can be longer than the physical LED strip.
+ *
+ * The canvas is a buffer of RGB triplets (3 bytes per pixel) owned by the caller, e.g. a
+ * pre-rendered banner in flash. The viewport has the size of the strip configured with
+ * DDBooster::init() and can be moved along the canvas.
+ *
+ * Moving the viewport by k pixels does not redraw the strip. The DD-Booster shifts the
+ * current content with one shiftUp/shiftDown command and only the k newly exposed pixels
+ * are sent. Equal neighbour pixels are combined into one range command.
+ *
+ * The scroll speed is independent of the frame rate. update() accumulates the elapsed time
+ * with sub-pixel precision and moves the viewport by the whole pixels passed since the last call.
+ */
+class DDViewport {
+public:
+
+    /**
+     * Creates a viewport for the canvas. The viewport starts at position 0, call redraw()
+     * to show the initial content.
+     * @param booster - Initialized DD-Booster instance the viewport is drawn to
+     * @param canvas - Canvas pixels as RGB triplets. Must stay valid while the viewport is used
+     * @param length - Number of pixels in the canvas
+     * @param wrap - If true the canvas is repeated endlessly, otherwise pixels outside the canvas are black
+     */
+    DDViewport(DDBooster &booster, const uint8_t *canvas, uint16_t length, bool wrap = true);
+
+    /**
+     * Sets the scroll speed used by update().
+     * @param speed - Speed in 1/256 pixel per second. Positive values move the viewport towards
+     *                the end of the canvas, so the content moves towards LED 0
+     */
+    void setSpeed(int32_t speed);
+
+    /**
+     * Moves the viewport according to the scroll speed and the elapsed time. The sub-pixel
+     * remainder is kept for the next call. Calls show() if the viewport was moved.
+     * @param elapsedMs - Time elapsed since the last call in milliseconds
+     * @return true if the viewport was moved
+     */
+    bool update(uint32_t elapsedMs);
+
+    /**
+     * Moves the viewport by the given number of pixels. Uses one shift command and sends only
+     * the newly exposed pixels. Moves larger than the strip cause a redraw.
+     * Does not call show().
+     * @param count - Number of pixels to move, negative values move towards the canvas start
+     */
+    void scrollBy(int32_t count);
+
+    /**
+     * Sets the viewport position and redraws the whole strip. Does not call show().
+     * @param position - Canvas index shown at LED 0. Can be negative if wrap is disabled
+     */
+    void moveTo(int32_t position);
+
+    /**
+     * Sends all pixels of the current viewport. Does not call show().
+     */
+    void redraw();
+
+    /**
+     * Returns the canvas index currently shown at LED 0.
+     */
+    int32_t getPosition() const;
+
+private:
+    const uint8_t *pixel(int32_t position) const;
+    void draw(uint16_t first, uint16_t last);
+
+    DDBooster &_booster;
+    const uint8_t *_canvas;
+    uint16_t _length;
+    bool _wrap;
+    int32_t _position;
+    int32_t _speed;
+    int32_t _remainder;
+};
+
+#endif //DD_BOOSTER_DDVIEWPORT_H
@@ -0,0 +1,103 @@
+/*
+ * DDWavReader.cpp - Reads 16 bit PCM WAV files as audio input
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDWavReader.h"
+
+#define WAV_FORMAT_PCM       1
+
+static uint32_t readLE(const uint8_t *data, uint8_t length)
+{
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        value |= (uint32_t) data[i] << (8 * i);
+    }
+    return value;
+}
+
+DDWavReader::DDWavReader()
+    : _file(NULL)
+    , _channels(0)
+    , _sampleRate(0)
+    , _remaining(0)
+{
+}
+
+bool DDWavReader::open(FILE *file)
+{
+    uint8_t header[12];
+    _file = NULL;
+
+    if (fread(header, 1, sizeof (header), file) != sizeof (header)
+            || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool format = false;
+    while (true) {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, sizeof (chunk), file) != sizeof (chunk)) {
+            return false;
+        }
+        uint32_t size = readLE(chunk + 4, 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fmt[16];
+            if (fread(fmt, 1, sizeof (fmt), file) != sizeof (fmt)) {
+                return false;
+            }
+            if (readLE(fmt, 2) != WAV_FORMAT_PCM || readLE(fmt + 14, 2) != 16) {
+                return false;
+            }
+            _channels = readLE(fmt + 2, 2);
+            _sampleRate = readLE(fmt + 4, 4);
+            format = _channels > 0;
+            size -= sizeof (fmt);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!format) {
+                return false;
+            }
+            _remaining = size / (2 * _channels);
+            _file = file;
+            return true;
+        }
+
+        // skip the rest of the chunk, chunks are padded to an even size
+        if (fseek(file, size + (size & 1), SEEK_CUR) != 0) {
+            return false;
+        }
+    }
+}
+
+uint16_t DDWavReader::read(int16_t *samples, uint16_t count)
+{
+    if (!_file) {
+        return 0;
+    }
+    if (count > _remaining) {
+        count = _remaining;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t sum = 0;
+        for (uint16_t c = 0; c < _channels; c++) {
+            uint8_t data[2];
+            if (fread(data, 1, 2, _file) != 2) {
+                _remaining = 0;
+                return i;
+            }
+            sum += (int16_t) readLE(data, 2);
+        }
+        samples[i] = sum / _channels;
+    }
+    _remaining -= count;
+    return count;
+}
+
+uint32_t DDWavReader::getSampleRate() const
+{
+    return _sampleRate;
+}
@@ -0,0 +1,50 @@
+/*
+ * DDWavReader.h - Reads 16 bit PCM WAV files as audio input
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDWAVREADER_H
+#define DD_BOOSTER_DDWAVREADER_H
+
+#include <mbed.h>
+
+/**
+ * @brief Reads the samples of a 16 bit PCM WAV file as mono blocks.
+ *
+ * Works with every stdio file, e.g. from a file system mounted with mbed or on a PC.
+ * Multi channel files are mixed down to mono.
+ */
+class DDWavReader {
+public:
+
+    DDWavReader();
+
+    /**
+     * Reads the header of a WAV file and moves to the first sample.
+     * @param file - Opened file, stays owned by the caller
+     * @return false if the file is no 16 bit PCM WAV file
+     */
+    bool open(FILE *file);
+
+    /**
+     * Reads the next samples.
+     * @param samples - Buffer for the mono samples
+     * @param count - Number of samples to read
+     * @return number of samples read, less than count at the end of the file
+     */
+    uint16_t read(int16_t *samples, uint16_t count);
+
+    /**
+     * Returns the sample rate of the file in Hz.
+     */
+    uint32_t getSampleRate() const;
+
+private:
+    FILE *_file;
+    uint16_t _channels;
+    uint32_t _sampleRate;
+    uint32_t _remaining;
+};
+
+#endif //DD_BOOSTER_DDWAVREADER_H
@@ -0,0 +1,149 @@
+/*
+ * DDArtNetLoadGenerator.cpp - Art-Net sender sending test frames at a fixed rate
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_NSAPI_PRESENT
+
+#include "DDArtNetLoadGenerator.h"
+
+#define ARTNET_OP_DMX        0x5000
+#define ARTNET_OP_SYNC       0x5200
+#define ARTNET_PROTOCOL      14
+
+#define ARTNET_HEADER_SIZE   18
+#define ARTNET_SYNC_SIZE     14
+#define ARTNET_LEDS_PER_UNIVERSE 170
+
+static const uint8_t ARTNET_ID[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+
+DDArtNetLoadGenerator::DDArtNetLoadGenerator(uint16_t universe, uint16_t pixels, uint16_t fps)
+    : _connected(false)
+    , _sync(true)
+    , _universe(universe & 0x7FFF)
+    , _pixels(pixels < 1 ? 1 : (pixels > MAX_PIXELS ? MAX_PIXELS : pixels))
+    , _period(1000000 / (fps ? fps : 1))
+    , _due(0)
+    , _frameNumber(0)
+    , _sequence(0)
+{
+    memset(&_stats, 0, sizeof (_stats));
+}
+
+DDArtNetLoadGenerator::~DDArtNetLoadGenerator()
+{
+    closeSocket();
+}
+
+void DDArtNetLoadGenerator::setSync(bool enabled)
+{
+    _sync = enabled;
+}
+
+nsapi_error_t DDArtNetLoadGenerator::connect(NetworkInterface *network, const char *host, uint16_t port)
+{
+    closeSocket();
+    if (!_address.set_ip_address(host)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    _address.set_port(port);
+    nsapi_error_t result = _socket.open(network);
+    if (result != NSAPI_ERROR_OK) {
+        return result;
+    }
+    _socket.set_blocking(false);
+    _connected = true;
+    memset(&_stats, 0, sizeof (_stats));
+    _due = us_ticker_read();
+    return NSAPI_ERROR_OK;
+}
+
+void DDArtNetLoadGenerator::poll()
+{
+    if (!_connected) {
+        return;
+    }
+
+    uint32_t now = us_ticker_read();
+    if ((int32_t) (now - _due) < 0) {
+        return;
+    }
+    _due += _period;
+    if ((int32_t) (now - _due) >= 0) {
+        // far behind, e.g. after a stall, restart the schedule
+        _due = now + _period;
+    }
+
+    memcpy(_buffer, ARTNET_ID, sizeof (ARTNET_ID));
+    _buffer[10] = 0;
+    _buffer[11] = ARTNET_PROTOCOL;
+
+    // a ramp moving by one pixel per frame, every pixel changes in every frame
+    _sequence = _sequence == 255 ? 1 : _sequence + 1;
+    for (uint16_t first = 0; first < _pixels; first += ARTNET_LEDS_PER_UNIVERSE) {
+        uint16_t count = _pixels - first < ARTNET_LEDS_PER_UNIVERSE ? _pixels - first : ARTNET_LEDS_PER_UNIVERSE;
+        // the DMX data length must be even
+        uint16_t length = (count * 3 + 1) & ~1;
+        uint16_t universe = _universe + first / ARTNET_LEDS_PER_UNIVERSE;
+
+        _buffer[8] = ARTNET_OP_DMX & 0xFF;
+        _buffer[9] = ARTNET_OP_DMX >> 8;
+        _buffer[12] = _sequence;
+        _buffer[13] = 0;
+        _buffer[14] = universe & 0xFF;
+        _buffer[15] = universe >> 8;
+        _buffer[16] = length >> 8;
+        _buffer[17] = length & 0xFF;
+        uint8_t *p = _buffer + ARTNET_HEADER_SIZE;
+        for (uint16_t i = first; i < first + count; i++) {
+            uint8_t v = (i + _frameNumber) * 8;
+            *p++ = v;
+            *p++ = 255 - v;
+            *p++ = _frameNumber;
+        }
+        *p = 0;
+        send(ARTNET_HEADER_SIZE + length);
+    }
+
+    if (_sync) {
+        _buffer[8] = ARTNET_OP_SYNC & 0xFF;
+        _buffer[9] = ARTNET_OP_SYNC >> 8;
+        _buffer[12] = 0;
+        _buffer[13] = 0;
+        send(ARTNET_SYNC_SIZE);
+    }
+    _frameNumber++;
+    _stats.frames++;
+}
+
+DDArtNetLoadGenerator::Stats DDArtNetLoadGenerator::getStats() const
+{
+    return _stats;
+}
+
+void DDArtNetLoadGenerator::send(uint16_t length)
+{
+    nsapi_size_or_error_t result = _socket.sendto(_address, _buffer, length);
+    if (result == NSAPI_ERROR_WOULD_BLOCK) {
+        _stats.dropped++;
+        return;
+    }
+    if (result < 0) {
+        closeSocket();
+        return;
+    }
+    _stats.packets++;
+    _stats.bytes += result;
+}
+
+void DDArtNetLoadGenerator::closeSocket()
+{
+    if (_connected) {
+        _socket.close();
+        _connected = false;
+    }
+}
+
+#endif // MBED_CONF_NSAPI_PRESENT
@@ -0,0 +1,95 @@
+/*
+ * DDArtNetLoadGenerator.h - Art-Net sender sending test frames at a fixed rate
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDARTNETLOADGENERATOR_H
+#define DD_BOOSTER_DDARTNETLOADGENERATOR_H
+
+#include "mbed.h"
+#include "UDPSocket.h"
+#include "NetworkInterface.h"
+
+/**
+ * @brief Load generator for DDArtNetReceiver or any other Art-Net node.
+ *
+ * Sends a moving color pattern at a fixed frame rate as ArtDmx packets, 170 pixels per
+ * universe starting with the given universe. With sync enabled, every frame is followed by
+ * an ArtSync packet. Switching sync off while sending simulates a controller which stops
+ * sending ArtSync. The socket is non-blocking, packets the socket does not accept are
+ * counted as dropped.
+ *
+ * Send to the receiver of the same device over the loopback address or to a node on another
+ * device.
+ */
+class DDArtNetLoadGenerator {
+public:
+
+    /**
+     * Maximal number of pixels per frame, four universes.
+     */
+    static const uint16_t MAX_PIXELS = 680;
+
+    /**
+     * Statistics since connect().
+     */
+    struct Stats {
+        uint32_t frames;
+        uint32_t packets;
+        uint32_t dropped;
+        uint32_t bytes;
+    };
+
+    /**
+     * @param universe - 15 bit Art-Net port address of the first universe
+     * @param pixels - Number of pixels per frame (1 - MAX_PIXELS)
+     * @param fps - Frames per second
+     */
+    DDArtNetLoadGenerator(uint16_t universe, uint16_t pixels, uint16_t fps);
+
+    ~DDArtNetLoadGenerator();
+
+    /**
+     * Enables or disables the ArtSync packet after each frame. Enabled by default.
+     */
+    void setSync(bool enabled);
+
+    /**
+     * Opens the socket and sets the destination.
+     * @param network - Connected network interface
+     * @param host - IP address of the node, e.g. "127.0.0.1"
+     * @param port - UDP port of the node, 6454 is default
+     * @return NSAPI_ERROR_OK on success
+     */
+    nsapi_error_t connect(NetworkInterface *network, const char *host, uint16_t port = 6454);
+
+    /**
+     * Sends the next frame when it is due. Call it from the main loop.
+     */
+    void poll();
+
+    /**
+     * Returns the statistics.
+     */
+    Stats getStats() const;
+
+private:
+    void send(uint16_t length);
+    void closeSocket();
+
+    UDPSocket _socket;
+    SocketAddress _address;
+    bool _connected;
+    bool _sync;
+    uint16_t _universe;
+    uint16_t _pixels;
+    uint32_t _period;
+    uint32_t _due;
+    uint32_t _frameNumber;
+    uint8_t _sequence;
+    Stats _stats;
+    uint8_t _buffer[18 + 512];
+};
+
+#endif //DD_BOOSTER_DDARTNETLOADGENERATOR_H
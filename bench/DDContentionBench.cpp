@@ -0,0 +1,138 @@
+/*
+ * DDContentionBench.cpp - Measures command submission from several threads
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_RTOS_PRESENT
+
+#include "DDContentionBench.h"
+#include "DDBoosterProtocol.h"
+
+DDContentionBench::DDContentionBench(DDSubmitter &submitter)
+    : _submitter(submitter)
+    , _transactions(0)
+    , _segment(1)
+    , _nextProducer(0)
+{
+}
+
+DDContentionBench::Result DDContentionBench::run(uint8_t producers, uint16_t transactions)
+{
+    if (producers < 1) {
+        producers = 1;
+    }
+    if (producers > MAX_PRODUCERS) {
+        producers = MAX_PRODUCERS;
+    }
+    _transactions = transactions;
+    _nextProducer = 0;
+    // every producer gets its own part of the strip, on short strips the parts overlap
+    uint16_t ledCount = _submitter.getLedCount();
+    _segment = ledCount / producers;
+    if (_segment == 0) {
+        _segment = 1;
+    }
+    if (_segment > 8) {
+        _segment = 8;
+    }
+    memset(_submitSum, 0, sizeof (_submitSum));
+    memset(_submitMax, 0, sizeof (_submitMax));
+    _submitter.resetStatistics();
+
+    uint32_t start = us_ticker_read();
+    {
+        // threads can only be started once, so they are created for each run
+        Thread threads[MAX_PRODUCERS];
+        for (uint8_t p = 0; p < producers; p++) {
+            threads[p].start(callback(this, &DDContentionBench::produce));
+        }
+        for (uint8_t p = 0; p < producers; p++) {
+            threads[p].join();
+        }
+    }
+
+    // queued transactions may still be sent after the producers finished
+    uint32_t total = (uint32_t) producers * transactions;
+    while (_submitter.getStats().transactions < total) {
+        Thread::wait(1);
+    }
+    uint32_t elapsed = us_ticker_read() - start;
+
+    Result result;
+    result.producers = producers;
+    result.transactions = total;
+    result.submitMax = 0;
+    uint64_t submitSum = 0;
+    for (uint8_t p = 0; p < producers; p++) {
+        submitSum += _submitSum[p];
+        if (_submitMax[p] > result.submitMax) {
+            result.submitMax = _submitMax[p];
+        }
+    }
+    result.submitAverage = total ? submitSum / total : 0;
+    DDSubmitter::Stats stats = _submitter.getStats();
+    result.latencyAverage = stats.transactions ? stats.latencySum / stats.transactions : 0;
+    result.latencyMax = stats.latencyMax;
+    result.throughput = elapsed ? (uint64_t) total * 1000000 / elapsed : 0;
+    return result;
+}
+
+void DDContentionBench::produce()
+{
+    core_util_critical_section_enter();
+    uint8_t id = _nextProducer++;
+    core_util_critical_section_exit();
+
+    uint16_t ledCount = _submitter.getLedCount();
+    uint8_t first = (id * _segment) % ledCount;
+    uint8_t last = first + _segment - 1 < ledCount ? first + _segment - 1 : ledCount - 1;
+
+    for (uint16_t i = 0; i < _transactions; i++) {
+        // every producer uses its own LEDs and colors
+        uint8_t led = first + i % (last - first + 1);
+        uint8_t cmd[7];
+        uint8_t length;
+        switch (i % 4) {
+        case 0:
+        case 1: {
+            uint8_t setLED[] = {BOOSTER_SETRGB, (uint8_t) (id * 32), (uint8_t) i, 0, BOOSTER_SETLED, led};
+            memcpy(cmd, setLED, sizeof (setLED));
+            length = sizeof (setLED);
+            break;
+        }
+        case 2: {
+            uint8_t setRange[] = {BOOSTER_SETRGB, 0, (uint8_t) (id * 32), (uint8_t) i, BOOSTER_SETRANGE, first, last};
+            memcpy(cmd, setRange, sizeof (setRange));
+            length = sizeof (setRange);
+            break;
+        }
+        default:
+            cmd[0] = BOOSTER_SHOW;
+            length = 1;
+            break;
+        }
+
+        uint32_t start = us_ticker_read();
+        while (!_submitter.submit(cmd, length)) {
+            Thread::wait(1);
+        }
+        uint32_t time = us_ticker_read() - start;
+        _submitSum[id] += time;
+        if (time > _submitMax[id]) {
+            _submitMax[id] = time;
+        }
+    }
+}
+
+void DDContentionBench::writeJson(FILE *file, const char *name, const Result &result)
+{
+    fprintf(file, "{\"name\":\"%s\",\"producers\":%u,\"transactions\":%lu,\"submit_avg_us\":%lu,\"submit_max_us\":%lu,"
+            "\"latency_avg_us\":%lu,\"latency_max_us\":%lu,\"throughput\":%lu}\n",
+            name, result.producers, (unsigned long) result.transactions, (unsigned long) result.submitAverage,
+            (unsigned long) result.submitMax, (unsigned long) result.latencyAverage,
+            (unsigned long) result.latencyMax, (unsigned long) result.throughput);
+}
+
+#endif // MBED_CONF_RTOS_PRESENT
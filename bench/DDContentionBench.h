@@ -0,0 +1,77 @@
+/*
+ * DDContentionBench.h - Measures command submission from several threads
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDCONTENTIONBENCH_H
+#define DD_BOOSTER_DDCONTENTIONBENCH_H
+
+#include "DDSubmitter.h"
+
+/**
+ * @brief Runs producer threads submitting mixed commands at the same time.
+ *
+ * Each producer repeats a mix of setLED, setRange and show transactions on its own part of
+ * the strip (up to 8 LEDs, overlapping if the strip is too short). The time each
+ * submit() call takes shows how long producers block each other, the latency until the
+ * transaction was sent (or the LEDs updated) is taken from the submitter. Running the
+ * benchmark with 1 to MAX_PRODUCERS producers shows how a submission path scales.
+ *
+ * Works with any DDBooster, a stubbed bus gives the pure locking and queueing behaviour.
+ */
+class DDContentionBench {
+public:
+
+    /**
+     * Maximal number of producer threads.
+     */
+    static const uint8_t MAX_PRODUCERS = 8;
+
+    /**
+     * Results of one run, times in microseconds.
+     */
+    struct Result {
+        uint8_t producers;
+        uint32_t transactions;
+        uint32_t submitAverage;
+        uint32_t submitMax;
+        uint32_t latencyAverage;
+        uint32_t latencyMax;
+        /** transactions per second over all producers */
+        uint32_t throughput;
+    };
+
+    /**
+     * @param submitter - Submission path to measure
+     */
+    DDContentionBench(DDSubmitter &submitter);
+
+    /**
+     * Runs the producers and waits until all transactions were sent.
+     * @param producers - Number of producer threads (1 - MAX_PRODUCERS)
+     * @param transactions - Transactions per producer
+     * @return measurements of the run
+     */
+    Result run(uint8_t producers, uint16_t transactions);
+
+    /**
+     * Writes a result as JSON object.
+     * @param file - Output, e.g. stdout
+     * @param name - Name of the submission path
+     * @param result - Result of run()
+     */
+    static void writeJson(FILE *file, const char *name, const Result &result);
+
+private:
+    void produce();
+
+    DDSubmitter &_submitter;
+    uint16_t _transactions;
+    uint16_t _segment;
+    volatile uint8_t _nextProducer;
+    uint32_t _submitSum[MAX_PRODUCERS];
+    uint32_t _submitMax[MAX_PRODUCERS];
+};
+
+#endif //DD_BOOSTER_DDCONTENTIONBENCH_H
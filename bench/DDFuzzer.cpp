@@ -0,0 +1,417 @@
+/*
+ * DDFuzzer.cpp - Differential fuzzing of the optimized encoders against plain per-LED commands
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDFuzzer.h"
+#include "DDScene.h"
+
+// a few colors only, so that equal neighbours and reused colors are frequent
+static const uint8_t PALETTE[][3] = {
+    {0, 0, 0},
+    {255, 0, 0},
+    {0, 255, 0},
+    {0, 0, 255},
+    {255, 255, 255},
+    {16, 32, 64}
+};
+
+#define PALETTE_SIZE         (sizeof (PALETTE) / sizeof (PALETTE[0]))
+
+DDFuzzer::DDFuzzer(DDBooster &optimized, DDBooster &naive, uint32_t seed)
+    : _optimized(optimized)
+    , _naive(naive)
+    , _frame(optimized)
+    , _random(seed ? seed : 1)
+    , _firstFailure(0)
+{
+    memset(&_stats, 0, sizeof (_stats));
+    _optimizedMonitor = _optimized.attachMonitor(callback(this, &DDFuzzer::onOptimized));
+    _naiveMonitor = _naive.attachMonitor(callback(this, &DDFuzzer::onNaive));
+}
+
+DDFuzzer::~DDFuzzer()
+{
+    _optimized.detachMonitor(_optimizedMonitor);
+    _naive.detachMonitor(_naiveMonitor);
+}
+
+bool DDFuzzer::runFrames(uint16_t cases)
+{
+    bool ok = true;
+    for (uint16_t c = 0; c < cases; c++) {
+        uint16_t ledCount = 1 + random(DDFrameBuffer::MAX_LEDS);
+        begin(ledCount);
+        _frame.invalidate();
+
+        bool passed = true;
+        uint8_t frames = 1 + random(8);
+        for (uint8_t f = 0; f < frames && passed; f++) {
+            randomFrame(ledCount);
+
+            switch (random(f > 0 ? 4 : 3)) {
+            case 0: {
+                // partial update first, the rest with the flush
+                uint16_t first = random(ledCount);
+                _frame.update(first, first + random(ledCount - first));
+                _frame.flush();
+                break;
+            }
+            case 3:
+                // the DD-Booster was reset, the shown state is restored before the new frame
+                _optimized.init(ledCount);
+                _frame.restore();
+                passed = compareRestored(ledCount);
+                _frame.flush();
+                break;
+            default:
+                _frame.flush();
+                break;
+            }
+
+            memcpy(_reference, _frame.getData(), ledCount * 3);
+            sendNaive(ledCount);
+            passed = passed && compare(ledCount);
+        }
+
+        end(passed);
+        ok = ok && passed;
+    }
+    return ok;
+}
+
+bool DDFuzzer::runScenes(uint16_t cases)
+{
+    DDSceneCompiler compiler(_stream, sizeof (_stream));
+
+    bool ok = true;
+    for (uint16_t c = 0; c < cases; c++) {
+        uint16_t ledCount = 1 + random(DDFrameBuffer::MAX_LEDS);
+        begin(ledCount);
+        memset(_reference, 0, sizeof (_reference));
+
+        uint16_t length = sprintf(_script, "leds %d\n", ledCount);
+        uint8_t count = 1 + random(MAX_OPS);
+        bool passed = true;
+
+        for (uint8_t i = 0; i < count; i++) {
+            Op op;
+            randomOp(op, ledCount);
+            if (i == 0 && op.type != OP_RGB) {
+                // the compiler expects a color before it is used
+                Op color;
+                color.type = OP_RGB;
+                color.args[0] = random(PALETTE_SIZE);
+                length += printOp(color, _script + length);
+                applyOp(color, ledCount);
+            }
+
+            if (random(8) == 0) {
+                // a loop around the statement, it is executed several times
+                uint8_t loops = 1 + random(3);
+                length += sprintf(_script + length, "loop %d\n", loops);
+                length += printOp(op, _script + length);
+                length += sprintf(_script + length, "end\n");
+                for (uint8_t l = 0; l < loops; l++) {
+                    applyOp(op, ledCount);
+                }
+            } else {
+                length += printOp(op, _script + length);
+                applyOp(op, ledCount);
+            }
+        }
+        length += sprintf(_script + length, "show\n");
+        sendNaive(ledCount);
+
+        if (!compiler.compile(_script)) {
+            passed = false;
+        } else {
+            // replay the records without their delays
+            const uint8_t *p = _stream;
+            const uint8_t *end = _stream + compiler.getLength();
+            while (p < end) {
+                while (*p & 0x80) {
+                    p++;
+                }
+                p++;
+                uint8_t size = *p++;
+                _optimizedEmulator.process(p, size);
+                p += size;
+            }
+            passed = compare(ledCount);
+        }
+
+        end(passed);
+        ok = ok && passed;
+    }
+    return ok;
+}
+
+uint32_t DDFuzzer::random(uint32_t range)
+{
+    // xorshift32
+    _random ^= _random << 13;
+    _random ^= _random >> 17;
+    _random ^= _random << 5;
+    return range ? _random % range : 0;
+}
+
+void DDFuzzer::randomFrame(uint16_t ledCount)
+{
+    uint8_t *data = _frame.getData();
+    const uint8_t *a = PALETTE[random(PALETTE_SIZE)];
+    const uint8_t *b = PALETTE[random(PALETTE_SIZE)];
+
+    switch (random(5)) {
+    case 0:
+        // a few changed LEDs
+        for (uint8_t i = random(8); i > 0; i--) {
+            memcpy(data + random(ledCount) * 3, a, 3);
+        }
+        break;
+    case 1:
+        // one color with exceptions
+        for (uint16_t i = 0; i < ledCount; i++) {
+            memcpy(data + i * 3, random(10) == 0 ? b : a, 3);
+        }
+        break;
+    case 2:
+        // gradient, every LED different
+        for (uint16_t i = 0; i < ledCount; i++) {
+            for (uint8_t c = 0; c < 3; c++) {
+                data[i * 3 + c] = a[c] + (b[c] - a[c]) * i / ledCount;
+            }
+        }
+        break;
+    case 3: {
+        // periodic pattern
+        uint8_t period = 1 + random(8);
+        for (uint16_t i = 0; i < ledCount; i++) {
+            memcpy(data + i * 3, PALETTE[(i % period) % PALETTE_SIZE], 3);
+        }
+        break;
+    }
+    default:
+        // random colors
+        for (uint16_t i = 0; i < ledCount * 3; i++) {
+            data[i] = random(256);
+        }
+        break;
+    }
+}
+
+void DDFuzzer::randomOp(Op &op, uint16_t ledCount)
+{
+    op.type = random(OP_COUNT);
+    for (uint8_t i = 0; i < 8; i++) {
+        op.args[i] = 0;
+    }
+
+    int16_t first = random(ledCount);
+    int16_t last = first + random(ledCount - first);
+    switch (op.type) {
+    case OP_RGB:
+        op.args[0] = random(PALETTE_SIZE);
+        break;
+    case OP_LED:
+        op.args[0] = first;
+        break;
+    case OP_RANGE:
+    case OP_COPY:
+        op.args[0] = first;
+        op.args[1] = last;
+        break;
+    case OP_GRADIENT:
+        op.args[0] = first;
+        op.args[1] = last;
+        op.args[2] = random(PALETTE_SIZE);
+        op.args[3] = random(PALETTE_SIZE);
+        break;
+    case OP_SHIFTUP:
+    case OP_SHIFTDOWN:
+    case OP_REPEAT:
+        op.args[0] = first;
+        op.args[1] = last;
+        op.args[2] = random(4);
+        break;
+    case OP_WAIT:
+        op.args[0] = random(200);
+        break;
+    default:
+        break;
+    }
+}
+
+uint16_t DDFuzzer::printOp(const Op &op, char *text)
+{
+    const int16_t *a = op.args;
+    switch (op.type) {
+    case OP_RGB:
+        return sprintf(text, "rgb %d %d %d\n", PALETTE[a[0]][0], PALETTE[a[0]][1], PALETTE[a[0]][2]);
+    case OP_LED:
+        return sprintf(text, "led %d\n", a[0]);
+    case OP_RANGE:
+        return sprintf(text, "range %d %d\n", a[0], a[1]);
+    case OP_ALL:
+        return sprintf(text, "all\n");
+    case OP_GRADIENT:
+        return sprintf(text, "gradient %d %d %d %d %d %d %d %d\n", a[0], a[1],
+                       PALETTE[a[2]][0], PALETTE[a[2]][1], PALETTE[a[2]][2],
+                       PALETTE[a[3]][0], PALETTE[a[3]][1], PALETTE[a[3]][2]);
+    case OP_SHIFTUP:
+        return sprintf(text, "shift up %d %d %d\n", a[0], a[1], a[2]);
+    case OP_SHIFTDOWN:
+        return sprintf(text, "shift down %d %d %d\n", a[0], a[1], a[2]);
+    case OP_COPY:
+        return sprintf(text, "copy %d %d\n", a[0], a[1]);
+    case OP_REPEAT:
+        return sprintf(text, "repeat %d %d %d\n", a[0], a[1], a[2]);
+    case OP_SHOW:
+        return sprintf(text, "show\n");
+    default:
+        return sprintf(text, "wait %d\n", a[0]);
+    }
+}
+
+void DDFuzzer::applyOp(const Op &op, uint16_t ledCount)
+{
+    // the statement semantics implemented independently of the emulator, LED by LED
+    const int16_t *a = op.args;
+    uint8_t *leds = _reference;
+    switch (op.type) {
+    case OP_RGB:
+        memcpy(_color, PALETTE[a[0]], 3);
+        break;
+    case OP_LED:
+        memcpy(leds + a[0] * 3, _color, 3);
+        break;
+    case OP_RANGE:
+        for (int16_t i = a[0]; i <= a[1]; i++) {
+            memcpy(leds + i * 3, _color, 3);
+        }
+        break;
+    case OP_ALL:
+        for (int16_t i = 0; i < ledCount; i++) {
+            memcpy(leds + i * 3, _color, 3);
+        }
+        break;
+    case OP_GRADIENT: {
+        int16_t steps = a[1] - a[0];
+        const uint8_t *from = PALETTE[a[2]];
+        const uint8_t *to = PALETTE[a[3]];
+        for (int16_t s = 0; s <= steps; s++) {
+            for (uint8_t c = 0; c < 3; c++) {
+                _color[c] = steps ? from[c] + (to[c] - from[c]) * s / steps : from[c];
+            }
+            memcpy(leds + (a[0] + s) * 3, _color, 3);
+        }
+        break;
+    }
+    case OP_SHIFTUP:
+        for (int16_t i = a[1]; i >= a[0] + a[2]; i--) {
+            memcpy(leds + i * 3, leds + (i - a[2]) * 3, 3);
+        }
+        break;
+    case OP_SHIFTDOWN:
+        for (int16_t i = a[0]; i + a[2] <= a[1]; i++) {
+            memcpy(leds + i * 3, leds + (i + a[2]) * 3, 3);
+        }
+        break;
+    case OP_COPY:
+        memcpy(leds + a[1] * 3, leds + a[0] * 3, 3);
+        break;
+    case OP_REPEAT: {
+        int16_t period = a[1] - a[0] + 1;
+        for (int16_t r = 0; r < a[2]; r++) {
+            for (int16_t i = 0; i < period; i++) {
+                int16_t target = a[1] + 1 + r * period + i;
+                if (target < ledCount) {
+                    memcpy(leds + target * 3, leds + (a[0] + i) * 3, 3);
+                }
+            }
+        }
+        break;
+    }
+    default:
+        // show and wait do not change the LEDs, only the final state is compared
+        break;
+    }
+}
+
+void DDFuzzer::sendNaive(uint16_t ledCount)
+{
+    for (uint16_t i = 0; i < ledCount; i++) {
+        const uint8_t *px = _reference + i * 3;
+        _naive.setRGB(px[0], px[1], px[2]);
+        _naive.setLED(i);
+    }
+    _naive.show();
+}
+
+bool DDFuzzer::compare(uint16_t ledCount)
+{
+    for (uint16_t i = 0; i < ledCount; i++) {
+        if (memcmp(_optimizedEmulator.getShown(i), _naiveEmulator.getShown(i), 3) != 0) {
+            return false;
+        }
+    }
+    return _optimizedEmulator.getErrors() == 0 && _naiveEmulator.getErrors() == 0;
+}
+
+bool DDFuzzer::compareRestored(uint16_t ledCount)
+{
+    // INIT clears the LED buffer but not the shown LEDs, only the buffer tells whether
+    // restore() sent the state again
+    for (uint16_t i = 0; i < ledCount; i++) {
+        if (memcmp(_optimizedEmulator.getLED(i), _naiveEmulator.getShown(i), 3) != 0) {
+            return false;
+        }
+    }
+    return compare(ledCount);
+}
+
+void DDFuzzer::begin(uint16_t ledCount)
+{
+    _optimized.init(ledCount);
+    _naive.init(ledCount);
+    _optimizedEmulator.reset(ledCount);
+    _naiveEmulator.reset(ledCount);
+    memset(_color, 0, sizeof (_color));
+}
+
+void DDFuzzer::end(bool ok)
+{
+    _stats.cases++;
+    if (!ok) {
+        _stats.failures++;
+        if (_firstFailure == 0) {
+            _firstFailure = _stats.cases;
+        }
+    }
+    _stats.optimizedBytes += _optimizedEmulator.getBytes();
+    _stats.naiveBytes += _naiveEmulator.getBytes();
+    _stats.optimizedTime += _optimizedEmulator.getTime();
+    _stats.naiveTime += _naiveEmulator.getTime();
+}
+
+const DDFuzzer::Stats &DDFuzzer::getStats() const
+{
+    return _stats;
+}
+
+uint32_t DDFuzzer::getFirstFailure() const
+{
+    return _firstFailure;
+}
+
+void DDFuzzer::onOptimized(const uint8_t *data, uint8_t length)
+{
+    _optimizedEmulator.process(data, length);
+}
+
+void DDFuzzer::onNaive(const uint8_t *data, uint8_t length)
+{
+    _naiveEmulator.process(data, length);
+}
@@ -0,0 +1,133 @@
+/*
+ * DDFuzzer.h - Differential fuzzing of the optimized encoders against plain per-LED commands
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDFUZZER_H
+#define DD_BOOSTER_DDFUZZER_H
+
+#include "DDFrameBuffer.h"
+#include "DDBoosterEmulator.h"
+
+/**
+ * @brief Checks that the optimized encoders produce the same LEDs as plain commands.
+ *
+ * Random test cases are sent on two paths, each into its own DDBoosterEmulator:
+ * - the optimized path uses the encoders of the library (DDFrameBuffer difference, setAll
+ *   and range encoding, restore() after a reset, the DDSceneCompiler optimizations)
+ * - the naive path sends every LED with setRGB and setLED, followed by show
+ * After each case the shown LEDs of both emulators are compared. The bytes and bus time of
+ * both paths are summed up to show the savings of the optimizations.
+ *
+ * The two DDBooster instances are only used for their commands, the traffic is captured with
+ * DDBooster::attachMonitor(). The fuzzer is intended for host builds, bench/host/fuzz.cpp
+ * runs it with the mbed stand-in of that folder. On a target both instances would send to
+ * their SPI buses. The same seed always creates the same cases, so failures can be
+ * reproduced.
+ */
+class DDFuzzer {
+public:
+
+    /**
+     * Results of all cases run so far.
+     */
+    struct Stats {
+        uint32_t cases;
+        uint32_t failures;
+        uint32_t optimizedBytes;
+        uint32_t naiveBytes;
+        uint32_t optimizedTime;
+        uint32_t naiveTime;
+    };
+
+    /**
+     * @param optimized - DD-Booster instance for the optimized path
+     * @param naive - DD-Booster instance for the naive path
+     * @param seed - Start value of the random generator, must not be 0
+     */
+    DDFuzzer(DDBooster &optimized, DDBooster &naive, uint32_t seed = 1);
+
+    ~DDFuzzer();
+
+    /**
+     * Runs random frame sequences through DDFrameBuffer: sparse changes, fills, gradients,
+     * periodic patterns, partial updates and restores after a simulated reset.
+     * @param cases - Number of sequences
+     * @return false if at least one case failed
+     */
+    bool runFrames(uint16_t cases);
+
+    /**
+     * Runs random scene scripts through DDSceneCompiler and compares the replayed stream
+     * with the statements executed LED by LED.
+     * @param cases - Number of scripts
+     * @return false if at least one case failed
+     */
+    bool runScenes(uint16_t cases);
+
+    /**
+     * Returns the results of all cases run so far.
+     */
+    const Stats &getStats() const;
+
+    /**
+     * Returns the number of the first failed case, starting with 1, or 0.
+     */
+    uint32_t getFirstFailure() const;
+
+private:
+    enum OpType {
+        OP_RGB,
+        OP_LED,
+        OP_RANGE,
+        OP_ALL,
+        OP_GRADIENT,
+        OP_SHIFTUP,
+        OP_SHIFTDOWN,
+        OP_COPY,
+        OP_REPEAT,
+        OP_SHOW,
+        OP_WAIT,
+        OP_COUNT
+    };
+
+    struct Op {
+        uint8_t type;
+        int16_t args[8];
+    };
+
+    static const uint8_t MAX_OPS = 24;
+    static const uint16_t SCRIPT_SIZE = 2048;
+    static const uint16_t STREAM_SIZE = 8192;
+
+    uint32_t random(uint32_t range);
+    void randomFrame(uint16_t ledCount);
+    void randomOp(Op &op, uint16_t ledCount);
+    uint16_t printOp(const Op &op, char *text);
+    void applyOp(const Op &op, uint16_t ledCount);
+    void sendNaive(uint16_t ledCount);
+    bool compare(uint16_t ledCount);
+    bool compareRestored(uint16_t ledCount);
+    void begin(uint16_t ledCount);
+    void end(bool ok);
+    void onOptimized(const uint8_t *data, uint8_t length);
+    void onNaive(const uint8_t *data, uint8_t length);
+
+    DDBooster &_optimized;
+    DDBooster &_naive;
+    int8_t _optimizedMonitor;
+    int8_t _naiveMonitor;
+    DDBoosterEmulator _optimizedEmulator;
+    DDBoosterEmulator _naiveEmulator;
+    DDFrameBuffer _frame;
+    uint32_t _random;
+    Stats _stats;
+    uint32_t _firstFailure;
+    uint8_t _reference[DDFrameBuffer::MAX_LEDS * 3];
+    uint8_t _color[3];
+    char _script[SCRIPT_SIZE];
+    uint8_t _stream[STREAM_SIZE];
+};
+
+#endif //DD_BOOSTER_DDFUZZER_H
@@ -0,0 +1,57 @@
+/*
+ * DDNoiseBench.cpp - Measures the per frame cost of the noise effects
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDNoiseBench.h"
+
+DDNoiseBench::DDNoiseBench(DDBooster &booster)
+    : _frame(booster)
+{
+}
+
+DDNoiseBench::Result DDNoiseBench::run(DDNoiseEffect &effect, uint16_t frames)
+{
+    Result result;
+    memset(&result, 0, sizeof (result));
+    if (frames == 0) {
+        return result;
+    }
+    _frame.clear();
+    _frame.invalidate();
+    _frame.flush();
+
+    uint64_t renderSum = 0;
+    uint64_t bytesSum = 0;
+    uint64_t busSum = 0;
+    for (uint16_t f = 0; f < frames; f++) {
+        uint32_t start = us_ticker_read();
+        effect.render(_frame);
+        uint32_t time = us_ticker_read() - start;
+        renderSum += time;
+        if (time > result.renderMax) {
+            result.renderMax = time;
+        }
+
+        DDFrameCost cost = _frame.estimate();
+        bytesSum += cost.bytes;
+        busSum += cost.getTime();
+        _frame.flush();
+    }
+
+    result.frames = frames;
+    result.renderAverage = renderSum / frames;
+    result.bytesAverage = bytesSum / frames;
+    result.busAverage = busSum / frames;
+    return result;
+}
+
+void DDNoiseBench::writeJson(FILE *file, const char *name, const Result &result) const
+{
+    fprintf(file, "{\"name\":\"%s\",\"leds\":%u,\"frames\":%lu,\"render_avg_us\":%lu,\"render_max_us\":%lu,"
+            "\"bytes_avg\":%lu,\"bus_avg_us\":%lu}\n",
+            name, _frame.getSize(), (unsigned long) result.frames, (unsigned long) result.renderAverage,
+            (unsigned long) result.renderMax, (unsigned long) result.bytesAverage, (unsigned long) result.busAverage);
+}
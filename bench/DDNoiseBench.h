@@ -0,0 +1,59 @@
+/*
+ * DDNoiseBench.h - Measures the per frame cost of the noise effects
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDNOISEBENCH_H
+#define DD_BOOSTER_DDNOISEBENCH_H
+
+#include "DDNoise.h"
+
+/**
+ * @brief Renders an effect for a number of frames and measures CPU and bus cost.
+ *
+ * For each frame the time of DDNoiseEffect::render() (compute, smoothing and change
+ * limit) is measured with the microsecond ticker. The bytes and the modeled bus time of
+ * the changes are taken from DDFrameBuffer::estimate() before the frame is flushed.
+ * Initialize the booster with the LED count to measure, e.g. 256.
+ */
+class DDNoiseBench {
+public:
+
+    /**
+     * Results of one run, times in microseconds.
+     */
+    struct Result {
+        uint32_t frames;
+        uint32_t renderAverage;
+        uint32_t renderMax;
+        uint32_t bytesAverage;
+        uint32_t busAverage;
+    };
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDNoiseBench(DDBooster &booster);
+
+    /**
+     * Renders and flushes frames of an effect, starting from a black frame.
+     * @param effect - Effect to measure
+     * @param frames - Number of frames
+     * @return measurements of the run
+     */
+    Result run(DDNoiseEffect &effect, uint16_t frames);
+
+    /**
+     * Writes a result as JSON object.
+     * @param file - Output, e.g. stdout
+     * @param name - Name of the effect
+     * @param result - Result of run()
+     */
+    void writeJson(FILE *file, const char *name, const Result &result) const;
+
+private:
+    DDFrameBuffer _frame;
+};
+
+#endif //DD_BOOSTER_DDNOISEBENCH_H
@@ -0,0 +1,139 @@
+/*
+ * DDOpcLoadGenerator.cpp - Open Pixel Control client sending test frames at a fixed rate
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#if MBED_CONF_NSAPI_PRESENT
+
+#include "DDOpcLoadGenerator.h"
+
+#define OPC_CMD_SET_PIXELS   0
+
+DDOpcLoadGenerator::DDOpcLoadGenerator(uint8_t channel, uint16_t pixels, uint16_t fps)
+    : _connected(false)
+    , _channel(channel)
+    , _pixels(pixels < 1 ? 1 : (pixels > MAX_PIXELS ? MAX_PIXELS : pixels))
+    , _period(1000000 / (fps ? fps : 1))
+    , _chunkSize(0)
+    , _due(0)
+    , _frameNumber(0)
+    , _length(0)
+    , _sent(0)
+{
+    memset(&_stats, 0, sizeof (_stats));
+}
+
+DDOpcLoadGenerator::~DDOpcLoadGenerator()
+{
+    closeSocket();
+}
+
+void DDOpcLoadGenerator::setChunkSize(uint16_t size)
+{
+    _chunkSize = size;
+}
+
+nsapi_error_t DDOpcLoadGenerator::connect(NetworkInterface *network, const char *host, uint16_t port)
+{
+    closeSocket();
+    nsapi_error_t result = _socket.open(network);
+    if (result != NSAPI_ERROR_OK) {
+        return result;
+    }
+    result = _socket.connect(host, port);
+    if (result != NSAPI_ERROR_OK) {
+        _socket.close();
+        return result;
+    }
+    _socket.set_blocking(false);
+    _connected = true;
+    memset(&_stats, 0, sizeof (_stats));
+    _length = 0;
+    _sent = 0;
+    _due = us_ticker_read();
+    return NSAPI_ERROR_OK;
+}
+
+void DDOpcLoadGenerator::poll()
+{
+    if (!_connected) {
+        return;
+    }
+
+    uint32_t now = us_ticker_read();
+    if ((int32_t) (now - _due) >= 0) {
+        if (_sent < _length) {
+            // the previous frame is still being sent, this one is skipped
+            _stats.dropped++;
+        } else {
+            render();
+        }
+        _due += _period;
+        if ((int32_t) (now - _due) >= 0) {
+            // far behind, e.g. after a stall, restart the schedule
+            _due = now + _period;
+        }
+    }
+
+    while (_sent < _length) {
+        uint16_t size = _length - _sent;
+        if (_chunkSize && size > _chunkSize) {
+            size = _chunkSize;
+        }
+        nsapi_size_or_error_t result = _socket.send(_buffer + _sent, size);
+        if (result == NSAPI_ERROR_WOULD_BLOCK) {
+            break;
+        }
+        if (result <= 0) {
+            closeSocket();
+            break;
+        }
+        _sent += result;
+        _stats.bytes += result;
+        if (_sent == _length) {
+            _stats.frames++;
+        }
+        if (_chunkSize) {
+            // one chunk per poll, so the server reads the frame in parts
+            break;
+        }
+    }
+}
+
+DDOpcLoadGenerator::Stats DDOpcLoadGenerator::getStats() const
+{
+    return _stats;
+}
+
+void DDOpcLoadGenerator::render()
+{
+    uint16_t data = _pixels * 3;
+    _buffer[0] = _channel;
+    _buffer[1] = OPC_CMD_SET_PIXELS;
+    _buffer[2] = data >> 8;
+    _buffer[3] = data & 0xFF;
+
+    // a ramp moving by one pixel per frame, every pixel changes in every frame
+    uint8_t *p = _buffer + 4;
+    for (uint16_t i = 0; i < _pixels; i++) {
+        uint8_t v = (i + _frameNumber) * 8;
+        *p++ = v;
+        *p++ = 255 - v;
+        *p++ = _frameNumber;
+    }
+    _frameNumber++;
+    _length = 4 + data;
+    _sent = 0;
+}
+
+void DDOpcLoadGenerator::closeSocket()
+{
+    if (_connected) {
+        _socket.close();
+        _connected = false;
+    }
+}
+
+#endif // MBED_CONF_NSAPI_PRESENT
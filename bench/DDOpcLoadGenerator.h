@@ -0,0 +1,96 @@
+/*
+ * DDOpcLoadGenerator.h - Open Pixel Control client sending test frames at a fixed rate
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDOPCLOADGENERATOR_H
+#define DD_BOOSTER_DDOPCLOADGENERATOR_H
+
+#include "mbed.h"
+#include "TCPSocket.h"
+#include "NetworkInterface.h"
+
+/**
+ * @brief Load generator for DDOpcServer or any other OPC server.
+ *
+ * Sends set pixel messages with a moving color pattern at a fixed frame rate. The socket is
+ * non-blocking: poll() sends as much of the current frame as the socket accepts. If the
+ * next frame is due before the current one was sent completely, the due frame is skipped
+ * and counted as dropped. A small chunk size splits every frame into many sends, which
+ * makes the server see partially received frames.
+ *
+ * Connect it to the server of the same device over the loopback address or to a server on
+ * another device.
+ */
+class DDOpcLoadGenerator {
+public:
+
+    /**
+     * Maximal number of pixels per frame.
+     */
+    static const uint16_t MAX_PIXELS = 512;
+
+    /**
+     * Statistics since connect().
+     */
+    struct Stats {
+        uint32_t frames;
+        uint32_t dropped;
+        uint32_t bytes;
+    };
+
+    /**
+     * @param channel - OPC channel, 0 is broadcast
+     * @param pixels - Number of pixels per frame (1 - MAX_PIXELS)
+     * @param fps - Frames per second
+     */
+    DDOpcLoadGenerator(uint8_t channel, uint16_t pixels, uint16_t fps);
+
+    ~DDOpcLoadGenerator();
+
+    /**
+     * Sets the maximal number of bytes passed to one send call.
+     * @param size - Chunk size in bytes, 0 sends as much as possible (default)
+     */
+    void setChunkSize(uint16_t size);
+
+    /**
+     * Connects to an OPC server.
+     * @param network - Connected network interface
+     * @param host - Address of the server, e.g. "127.0.0.1"
+     * @param port - TCP port of the server
+     * @return NSAPI_ERROR_OK on success
+     */
+    nsapi_error_t connect(NetworkInterface *network, const char *host, uint16_t port);
+
+    /**
+     * Sends the pending data and starts the next frame when it is due.
+     * Call it from the main loop.
+     */
+    void poll();
+
+    /**
+     * Returns the statistics.
+     */
+    Stats getStats() const;
+
+private:
+    void render();
+    void closeSocket();
+
+    TCPSocket _socket;
+    bool _connected;
+    uint8_t _channel;
+    uint16_t _pixels;
+    uint32_t _period;
+    uint16_t _chunkSize;
+    uint32_t _due;
+    uint32_t _frameNumber;
+    uint16_t _length;
+    uint16_t _sent;
+    Stats _stats;
+    uint8_t _buffer[4 + MAX_PIXELS * 3];
+};
+
+#endif //DD_BOOSTER_DDOPCLOADGENERATOR_H
@@ -0,0 +1,116 @@
+/*
+ * DDTransportBench.cpp - Compares the transfer and pacing modes of the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDTransportBench.h"
+
+static const struct {
+    const char *name;
+    DDBooster::TransferMode transfer;
+    bool deferred;
+} MODES[DDTransportBench::NUM_MODES] = {
+    {"blocking-bytes", DDBooster::TRANSFER_BYTES, false},
+    {"blocking-block", DDBooster::TRANSFER_BLOCK, false},
+    {"deferred-bytes", DDBooster::TRANSFER_BYTES, true},
+    {"deferred-block", DDBooster::TRANSFER_BLOCK, true}
+};
+
+DDTransportBench::DDTransportBench(DDBooster &booster)
+    : _booster(booster)
+    , _frame(booster)
+{
+    memset(_results, 0, sizeof (_results));
+}
+
+void DDTransportBench::run(DDWorkload &workload, uint32_t seed, uint16_t frames)
+{
+    if (frames > MAX_FRAMES) {
+        frames = MAX_FRAMES;
+    }
+    if (frames == 0) {
+        return;
+    }
+    uint16_t count = _frame.getSize();
+    int8_t monitor = _booster.attachMonitor(callback(this, &DDTransportBench::onTransaction));
+
+    for (uint8_t m = 0; m < NUM_MODES; m++) {
+        _booster.setTransferMode(MODES[m].transfer);
+        _booster.setDeferredDelays(MODES[m].deferred);
+        workload.restart(seed);
+        _frame.clear();
+        _frame.invalidate();
+        _emulator.reset(count);
+
+        uint32_t frameTime = 0;
+        uint32_t callTime = 0;
+        uint32_t waitStart = _booster.getWaitTime();
+
+        for (uint16_t f = 0; f < frames; f++) {
+            workload.next(_frame.getData(), count);
+
+            uint32_t start = us_ticker_read();
+            _frame.flush();
+            uint32_t returned = us_ticker_read();
+            while (!_booster.isReady()) {
+                // the application could work here, the LEDs are updated when it is ready
+            }
+            uint32_t latched = us_ticker_read();
+
+            callTime += returned - start;
+            frameTime += latched - start;
+            _latency[f] = latched - start;
+        }
+
+        // insertion sort, the number of frames is small
+        for (uint16_t i = 1; i < frames; i++) {
+            uint32_t value = _latency[i];
+            uint16_t j = i;
+            for (; j > 0 && _latency[j - 1] > value; j--) {
+                _latency[j] = _latency[j - 1];
+            }
+            _latency[j] = value;
+        }
+
+        Result &result = _results[m];
+        result.name = MODES[m].name;
+        result.frames = frames;
+        result.frameTime = frameTime / frames;
+        result.callTime = callTime / frames;
+        result.waitTime = (_booster.getWaitTime() - waitStart) / frames;
+        result.modeledTime = _emulator.getTime() / frames;
+        result.latencyP50 = _latency[(frames - 1) / 2];
+        result.latencyP99 = _latency[(frames - 1) * 99 / 100];
+        result.latencyMax = _latency[frames - 1];
+    }
+
+    _booster.setDeferredDelays(false);
+    _booster.setTransferMode(DDBooster::TRANSFER_BYTES);
+    _booster.detachMonitor(monitor);
+}
+
+const DDTransportBench::Result &DDTransportBench::getResult(uint8_t mode) const
+{
+    return _results[mode < NUM_MODES ? mode : NUM_MODES - 1];
+}
+
+void DDTransportBench::writeJson(FILE *file) const
+{
+    fprintf(file, "{\"leds\":%u,\"modes\":[", _frame.getSize());
+    for (uint8_t m = 0; m < NUM_MODES; m++) {
+        const Result &r = _results[m];
+        fprintf(file, "%s{\"name\":\"%s\",\"frames\":%lu,\"frame_us\":%lu,\"call_us\":%lu,\"wait_us\":%lu,"
+                "\"modeled_us\":%lu,\"latency_p50_us\":%lu,\"latency_p99_us\":%lu,\"latency_max_us\":%lu}",
+                m ? "," : "", r.name ? r.name : "", (unsigned long) r.frames, (unsigned long) r.frameTime,
+                (unsigned long) r.callTime, (unsigned long) r.waitTime, (unsigned long) r.modeledTime,
+                (unsigned long) r.latencyP50, (unsigned long) r.latencyP99, (unsigned long) r.latencyMax);
+    }
+    fprintf(file, "]}\n");
+}
+
+void DDTransportBench::onTransaction(const uint8_t *data, uint8_t length)
+{
+    _emulator.process(data, length);
+}
@@ -0,0 +1,91 @@
+/*
+ * DDTransportBench.h - Compares the transfer and pacing modes of the Digi-Dot-Booster
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDTRANSPORTBENCH_H
+#define DD_BOOSTER_DDTRANSPORTBENCH_H
+
+#include "DDWorkload.h"
+
+/**
+ * @brief Sends the same workload with every transfer and pacing mode and measures the timing.
+ *
+ * The modes combine the SPI transfer (byte by byte or one block per transaction, see
+ * DDBooster::setTransferMode()) with the pacing (blocking delays or deferred delays, see
+ * DDBooster::setDeferredDelays()). For each mode the frames are sent with
+ * DDFrameBuffer::flush() and measured on the running hardware:
+ * - frame time: from the flush() call until the LEDs are updated
+ * - call time: time spent in the flush() call
+ * - wait time: time the library spent waiting for the DD-Booster
+ * - latency percentiles of the frame time
+ * - modeled frame time of the sent commands (DDBoosterEmulator)
+ *
+ * All times are averages per frame in microseconds. The results can be written as JSON.
+ * Afterwards the DD-Booster is left with blocking delays and byte transfers.
+ */
+class DDTransportBench {
+public:
+
+    /**
+     * Number of compared modes.
+     */
+    static const uint8_t NUM_MODES = 4;
+
+    /**
+     * Maximal number of frames per run, used for the latency percentiles.
+     */
+    static const uint16_t MAX_FRAMES = 256;
+
+    /**
+     * Measurements of one mode.
+     */
+    struct Result {
+        const char *name;
+        uint32_t frames;
+        uint32_t frameTime;
+        uint32_t callTime;
+        uint32_t waitTime;
+        uint32_t modeledTime;
+        uint32_t latencyP50;
+        uint32_t latencyP99;
+        uint32_t latencyMax;
+    };
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDTransportBench(DDBooster &booster);
+
+    /**
+     * Sends a workload with every mode.
+     * @param workload - Frame generator, restarted with the seed for each mode
+     * @param seed - Seed of the sequence
+     * @param frames - Number of frames, at most MAX_FRAMES
+     */
+    void run(DDWorkload &workload, uint32_t seed, uint16_t frames);
+
+    /**
+     * Returns the measurements of a mode after run().
+     * @param mode - Mode index (0 - NUM_MODES-1)
+     */
+    const Result &getResult(uint8_t mode) const;
+
+    /**
+     * Writes the results of the last run as JSON object.
+     * @param file - Output, e.g. stdout
+     */
+    void writeJson(FILE *file) const;
+
+private:
+    void onTransaction(const uint8_t *data, uint8_t length);
+
+    DDBooster &_booster;
+    DDFrameBuffer _frame;
+    DDBoosterEmulator _emulator;
+    Result _results[NUM_MODES];
+    uint32_t _latency[MAX_FRAMES];
+};
+
+#endif //DD_BOOSTER_DDTRANSPORTBENCH_H
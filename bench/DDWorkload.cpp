@@ -0,0 +1,153 @@
+/*
+ * DDWorkload.cpp - Synthetic frame sequences for benchmarking the Digi-Dot-Booster encoders
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+#include "DDWorkload.h"
+
+DDWorkload::DDWorkload(const Shape &shape, uint32_t seed)
+    : _shape(shape)
+{
+    if (_shape.colors > MAX_COLORS) {
+        _shape.colors = MAX_COLORS;
+    }
+    if (_shape.runLength == 0) {
+        _shape.runLength = 1;
+    }
+    restart(seed);
+}
+
+void DDWorkload::restart(uint32_t seed)
+{
+    _random = seed ? seed : 1;
+    for (uint8_t i = 0; i < MAX_COLORS; i++) {
+        for (uint8_t c = 0; c < 3; c++) {
+            _palette[i][c] = random(256);
+        }
+    }
+}
+
+uint32_t DDWorkload::random(uint32_t range)
+{
+    // xorshift32
+    _random ^= _random << 13;
+    _random ^= _random >> 17;
+    _random ^= _random << 5;
+    return range ? _random % range : 0;
+}
+
+void DDWorkload::next(uint8_t *frame, uint16_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    if (_shape.scroll != 0) {
+        // rotate by reversing the parts and the whole, needs no second buffer
+        uint16_t shift = (_shape.scroll > 0 ? _shape.scroll : count - (-_shape.scroll % count)) % count;
+        uint16_t ranges[3][2] = {{0, count - shift}, {count - shift, count}, {0, count}};
+        for (uint8_t r = 0; r < 3; r++) {
+            uint16_t a = ranges[r][0];
+            uint16_t b = ranges[r][1];
+            while (a + 1 < b) {
+                b--;
+                for (uint8_t c = 0; c < 3; c++) {
+                    uint8_t t = frame[a * 3 + c];
+                    frame[a * 3 + c] = frame[b * 3 + c];
+                    frame[b * 3 + c] = t;
+                }
+                a++;
+            }
+        }
+    }
+
+    if (_shape.fade) {
+        for (uint16_t i = 0; i < count * 3; i++) {
+            frame[i] = frame[i] * (255 - _shape.fade) / 255;
+        }
+    }
+
+    uint32_t painted = 0;
+    uint32_t target = (uint32_t) count * _shape.density / 255;
+    while (painted < target) {
+        uint16_t length = 1 + random(2 * _shape.runLength - 1);
+        uint16_t start = random(count);
+        uint8_t color[3];
+        if (_shape.colors) {
+            memcpy(color, _palette[random(_shape.colors)], 3);
+        } else {
+            for (uint8_t c = 0; c < 3; c++) {
+                color[c] = random(256);
+            }
+        }
+        for (uint16_t i = start; i < start + length && i < count; i++) {
+            memcpy(frame + i * 3, color, 3);
+        }
+        painted += length;
+    }
+
+    if (_shape.period && _shape.period < count) {
+        for (uint16_t i = _shape.period; i < count; i++) {
+            memcpy(frame + i * 3, frame + (i % _shape.period) * 3, 3);
+        }
+    }
+}
+
+uint32_t DDWorkloadBench::Result::getFps() const
+{
+    return time ? (uint64_t) frames * 1000000 / time : 0;
+}
+
+DDWorkloadBench::DDWorkloadBench(DDBooster &booster)
+    : _booster(booster)
+    , _frame(booster)
+{
+}
+
+void DDWorkloadBench::run(DDWorkload &workload, uint32_t seed, uint16_t frames, Result *results)
+{
+    uint16_t count = _frame.getSize();
+    int8_t monitor = _booster.attachMonitor(callback(this, &DDWorkloadBench::onTransaction));
+
+    for (uint8_t s = 0; s < NUM_STRATEGIES; s++) {
+        workload.restart(seed);
+        _frame.clear();
+        _frame.invalidate();
+        _emulator.reset(count);
+
+        for (uint16_t f = 0; f < frames; f++) {
+            workload.next(_frame.getData(), count);
+            switch (s) {
+            case STRATEGY_NAIVE:
+                for (uint16_t i = 0; i < count; i++) {
+                    const uint8_t *px = _frame.getPixel(i);
+                    _booster.setRGB(px[0], px[1], px[2]);
+                    _booster.setLED(i);
+                }
+                _booster.show();
+                break;
+            case STRATEGY_FULL:
+                _frame.invalidate();
+                _frame.flush();
+                break;
+            default:
+                _frame.flush();
+                break;
+            }
+        }
+
+        results[s].frames = frames;
+        results[s].bytes = _emulator.getBytes();
+        results[s].transactions = _emulator.getTransactions();
+        results[s].time = _emulator.getTime();
+    }
+
+    _booster.detachMonitor(monitor);
+}
+
+void DDWorkloadBench::onTransaction(const uint8_t *data, uint8_t length)
+{
+    _emulator.process(data, length);
+}
@@ -0,0 +1,130 @@
+/*
+ * DDWorkload.h - Synthetic frame sequences for benchmarking the Digi-Dot-Booster encoders
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_DDWORKLOAD_H
+#define DD_BOOSTER_DDWORKLOAD_H
+
+#include "DDFrameBuffer.h"
+#include "DDBoosterEmulator.h"
+
+/**
+ * @brief Generates reproducible frame sequences with controllable content properties.
+ *
+ * Each frame is derived from the previous one in this order: the content scrolls, fades,
+ * runs of new colors are painted and, if a period is set, the first period is repeated over
+ * the strip. The same shape and seed always create the same sequence.
+ */
+class DDWorkload {
+public:
+
+    /**
+     * Maximal number of palette colors.
+     */
+    static const uint8_t MAX_COLORS = 16;
+
+    /**
+     * Properties of the generated content.
+     */
+    struct Shape {
+        /** Part of the LEDs painted with new colors per frame (0 - 255 = 0 - 100%) */
+        uint8_t density;
+        /** Average length of a painted run in LEDs, the lengths are uniform in 1 - 2*runLength-1 */
+        uint8_t runLength;
+        /** Number of palette colors (1 - MAX_COLORS), 0 for random colors */
+        uint8_t colors;
+        /** LEDs the content moves per frame, negative values move down */
+        int8_t scroll;
+        /** Length of a repeated pattern in LEDs, 0 for none */
+        uint8_t period;
+        /** Brightness reduction per frame (0 - 255), 0 for none */
+        uint8_t fade;
+    };
+
+    /**
+     * @param shape - Content properties
+     * @param seed - Start value of the random generator, must not be 0
+     */
+    DDWorkload(const Shape &shape, uint32_t seed = 1);
+
+    /**
+     * Restarts the sequence with a new seed. The palette is created again.
+     * @param seed - Start value of the random generator, must not be 0
+     */
+    void restart(uint32_t seed);
+
+    /**
+     * Turns the previous frame into the next one.
+     * @param frame - RGB triplets, contains the previous frame (black for the first one)
+     * @param count - Number of LEDs
+     */
+    void next(uint8_t *frame, uint16_t count);
+
+private:
+    uint32_t random(uint32_t range);
+
+    Shape _shape;
+    uint32_t _random;
+    uint8_t _palette[MAX_COLORS][3];
+};
+
+/**
+ * @brief Sends workloads with different strategies and compares their bus costs.
+ *
+ * Every strategy sends the same frame sequence through the DD-Booster. The traffic is
+ * captured with DDBooster::attachMonitor() and measured by a DDBoosterEmulator, the modeled
+ * frame rate follows from the command delays, the SPI time and the LED update time.
+ */
+class DDWorkloadBench {
+public:
+
+    enum Strategy {
+        /** every LED with its own setRGB and setLED transaction */
+        STRATEGY_NAIVE,
+        /** the whole frame with setAll and ranges, like the first flush() */
+        STRATEGY_FULL,
+        /** only the changes with DDFrameBuffer::flush() */
+        STRATEGY_DIFF,
+        NUM_STRATEGIES
+    };
+
+    /**
+     * Costs of a workload sent with one strategy.
+     */
+    struct Result {
+        uint32_t frames;
+        uint32_t bytes;
+        uint32_t transactions;
+        uint32_t time;
+
+        /**
+         * Returns the modeled frame rate in frames per second.
+         */
+        uint32_t getFps() const;
+    };
+
+    /**
+     * @param booster - Initialized DD-Booster instance
+     */
+    DDWorkloadBench(DDBooster &booster);
+
+    /**
+     * Sends a workload with every strategy.
+     * @param workload - Frame generator, restarted with the seed for each strategy
+     * @param seed - Seed of the sequence
+     * @param frames - Number of frames
+     * @param results - Results, indexed by Strategy, NUM_STRATEGIES entries
+     */
+    void run(DDWorkload &workload, uint32_t seed, uint16_t frames, Result *results);
+
+private:
+    void onTransaction(const uint8_t *data, uint8_t length);
+
+    DDBooster &_booster;
+    DDFrameBuffer _frame;
+    DDBoosterEmulator _emulator;
+};
+
+#endif //DD_BOOSTER_DDWORKLOAD_H
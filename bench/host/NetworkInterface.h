@@ -0,0 +1,73 @@
+/*
+ * NetworkInterface.h - Minimal stand-in for the mbed network interface on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_HOST_NETWORKINTERFACE_H
+#define DD_BOOSTER_HOST_NETWORKINTERFACE_H
+
+/*
+ * Only IPv4 addresses and the error codes used by the library are provided. The network
+ * interface has no function, the sockets use the network stack of the host directly.
+ */
+
+#include "mbed.h"
+#include <arpa/inet.h>
+
+typedef int nsapi_error_t;
+typedef int nsapi_size_or_error_t;
+
+enum {
+    NSAPI_ERROR_OK = 0,
+    NSAPI_ERROR_WOULD_BLOCK = -3001,
+    NSAPI_ERROR_PARAMETER = -3003,
+    NSAPI_ERROR_NO_SOCKET = -3005,
+    NSAPI_ERROR_DEVICE_ERROR = -3012
+};
+
+class SocketAddress {
+public:
+    SocketAddress(const char *address = NULL, uint16_t port = 0)
+        : _ip(0)
+        , _port(port)
+    {
+        if (address) {
+            set_ip_address(address);
+        }
+    }
+
+    bool set_ip_address(const char *address)
+    {
+        struct in_addr ip;
+        if (inet_pton(AF_INET, address, &ip) != 1) {
+            return false;
+        }
+        _ip = ip.s_addr;
+        return true;
+    }
+
+    void set_port(uint16_t port)
+    {
+        _port = port;
+    }
+
+    uint16_t get_port() const
+    {
+        return _port;
+    }
+
+    uint32_t get_ip() const
+    {
+        return _ip;
+    }
+
+private:
+    uint32_t _ip;
+    uint16_t _port;
+};
+
+class NetworkInterface {
+};
+
+#endif //DD_BOOSTER_HOST_NETWORKINTERFACE_H
@@ -0,0 +1,91 @@
+/*
+ * UDPSocket.h - Minimal stand-in for the mbed UDP socket on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_HOST_UDPSOCKET_H
+#define DD_BOOSTER_HOST_UDPSOCKET_H
+
+/*
+ * A UDP socket of the host, bound to the loopback address, so a sender and a receiver in
+ * the same program can talk to each other.
+ */
+
+#include "NetworkInterface.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+class UDPSocket {
+public:
+    UDPSocket()
+        : _fd(-1)
+    {
+    }
+
+    ~UDPSocket()
+    {
+        close();
+    }
+
+    nsapi_error_t open(NetworkInterface *network)
+    {
+        _fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        return _fd >= 0 ? NSAPI_ERROR_OK : NSAPI_ERROR_NO_SOCKET;
+    }
+
+    nsapi_error_t bind(uint16_t port)
+    {
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof (address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return ::bind(_fd, (struct sockaddr *) &address, sizeof (address)) == 0 ? NSAPI_ERROR_OK : NSAPI_ERROR_PARAMETER;
+    }
+
+    void set_blocking(bool blocking)
+    {
+        int flags = fcntl(_fd, F_GETFL, 0);
+        fcntl(_fd, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+    }
+
+    nsapi_size_or_error_t sendto(const SocketAddress &address, const void *data, unsigned size)
+    {
+        struct sockaddr_in to;
+        memset(&to, 0, sizeof (to));
+        to.sin_family = AF_INET;
+        to.sin_port = htons(address.get_port());
+        to.sin_addr.s_addr = address.get_ip();
+        ssize_t result = ::sendto(_fd, data, size, 0, (struct sockaddr *) &to, sizeof (to));
+        return result >= 0 ? result : error();
+    }
+
+    nsapi_size_or_error_t recvfrom(SocketAddress *address, void *data, unsigned size)
+    {
+        ssize_t result = ::recvfrom(_fd, data, size, 0, NULL, NULL);
+        return result >= 0 ? result : error();
+    }
+
+    nsapi_error_t close()
+    {
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+        return NSAPI_ERROR_OK;
+    }
+
+private:
+    static nsapi_error_t error()
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK ? NSAPI_ERROR_WOULD_BLOCK : NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    int _fd;
+};
+
+#endif //DD_BOOSTER_HOST_UDPSOCKET_H
@@ -0,0 +1,93 @@
+/*
+ * artnet_check.cpp - Sends Art-Net over loopback to DDArtNetReceiver on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -DMBED_CONF_NSAPI_PRESENT=1 -Ibench/host -I. -Ibench -o artnet_check \
+ *       bench/host/artnet_check.cpp bench/DDArtNetLoadGenerator.cpp DDArtNetReceiver.cpp \
+ *       DDFrameBuffer.cpp DDBooster.cpp
+ *   ./artnet_check
+ *
+ * A DDArtNetLoadGenerator sends 256 pixels in two universes at 50 fps over UDP loopback to
+ * a DDArtNetReceiver. With ArtSync every frame must be shown. After the generator stops
+ * sending ArtSync, the receiver must not show anything until SYNC_TIMEOUT has passed, the
+ * time is moved forward for that, and afterwards every frame must be shown again on its
+ * last universe. Exits with 0 if all checks passed.
+ */
+
+#include "DDArtNetReceiver.h"
+#include "DDArtNetLoadGenerator.h"
+
+static const uint16_t PORT = 16454;
+static const uint16_t LED_COUNT = 256;
+
+static uint32_t shows;
+
+static void onTransaction(const uint8_t *data, uint8_t length)
+{
+    if (DDBooster::containsShow(data, length)) {
+        shows++;
+    }
+}
+
+// runs sender and receiver for the given time, returns the number of frames sent
+static uint32_t run(DDArtNetLoadGenerator &generator, DDArtNetReceiver &receiver, uint32_t ms)
+{
+    uint32_t frames = generator.getStats().frames;
+    uint32_t start = us_ticker_read();
+    shows = 0;
+    while (us_ticker_read() - start < ms * 1000) {
+        generator.poll();
+        receiver.poll();
+    }
+    // the last packets are still in the socket
+    wait_ms(1);
+    receiver.poll();
+    return generator.getStats().frames - frames;
+}
+
+static bool check(const char *name, uint32_t frames, bool ok)
+{
+    printf("%s: %lu frames, %lu shown, %s\n", name, (unsigned long) frames, (unsigned long) shows,
+           ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main()
+{
+    DDBooster booster(0, 0, 0, NC);
+    booster.init(LED_COUNT);
+    booster.attachMonitor(onTransaction);
+    DDFrameBuffer frame(booster);
+
+    NetworkInterface network;
+    DDArtNetReceiver receiver;
+    receiver.addMapping(0, frame, 0, 170);
+    receiver.addMapping(1, frame, 170, LED_COUNT - 170);
+    DDArtNetLoadGenerator generator(0, LED_COUNT, 50);
+    if (receiver.open(&network, PORT) != NSAPI_ERROR_OK
+            || generator.connect(&network, "127.0.0.1", PORT) != NSAPI_ERROR_OK) {
+        printf("no loopback socket\n");
+        return 1;
+    }
+
+    bool ok = true;
+    uint32_t frames = run(generator, receiver, 500);
+    ok = check("sync", frames, frames > 0 && shows == frames) && ok;
+
+    generator.setSync(false);
+    frames = run(generator, receiver, 500);
+    ok = check("sync stopped", frames, frames > 0 && shows == 0) && ok;
+
+    host_advance_time(DDArtNetReceiver::SYNC_TIMEOUT);
+    frames = run(generator, receiver, 500);
+    ok = check("after timeout", frames, frames > 0 && shows == frames) && ok;
+
+    ok = ok && generator.getStats().dropped == 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/*
+ * audio_check.cpp - Runs a WAV file through DDWavReader and DDAudioVisualizer on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -Ibench/host -I. -o audio_check bench/host/audio_check.cpp \
+ *       DDAudio.cpp DDWavReader.cpp DDFrameBuffer.cpp DDBooster.cpp
+ *   ./audio_check [file.wav]
+ *
+ * Without a file a stereo test file is generated: a tone in the middle of each band, one
+ * after the other, then four bass kicks. The tone's band must reach a high level while the
+ * bands two or more bands away stay low, and every kick must be detected as one beat.
+ *
+ * The blocks are pushed at the pace of the sample rate, the latency bound is one block. A
+ * block polled right away must be shown within the bound. In a second run a block is
+ * replaced before it is polled, or the time is moved past the bound before the poll, both
+ * must be counted as dropped and not shown.
+ *
+ * With a file, the band levels and beats are printed and only the latency is checked.
+ * Exits with 0 if all checks passed.
+ */
+
+#include "DDAudio.h"
+#include "DDWavReader.h"
+#include <math.h>
+
+static const uint16_t BLOCK = DDAudioAnalyzer::BLOCK_SIZE;
+static const uint32_t SAMPLE_RATE = 44100;
+static const uint16_t TONE_BLOCKS = 100;
+static const uint16_t KICK_BLOCKS = 150;
+static const uint8_t KICKS = 4;
+
+// first FFT bin of each band, as in DDAudio.cpp
+static const uint8_t BAND_EDGES[DDAudioAnalyzer::NUM_BANDS + 1] = {1, 2, 3, 5, 8, 13, 21, 34, 64};
+
+static void writeLE(FILE *file, uint32_t value, uint8_t length)
+{
+    for (uint8_t i = 0; i < length; i++) {
+        fputc((value >> (8 * i)) & 0xFF, file);
+    }
+}
+
+static float signal(uint32_t n)
+{
+    uint32_t block = n / BLOCK;
+    uint8_t band = block / TONE_BLOCKS;
+    if (band < DDAudioAnalyzer::NUM_BANDS) {
+        // a tone on the middle bin of the band
+        float bin = (BAND_EDGES[band] + BAND_EDGES[band + 1] - 1) / 2;
+        return 0.5f * sinf(2 * M_PI * bin * n / BLOCK);
+    }
+
+    // a decaying tone on bin 1 at the start of every KICK_BLOCKS blocks
+    uint32_t t = n - DDAudioAnalyzer::NUM_BANDS * TONE_BLOCKS * BLOCK;
+    uint32_t since = t % (KICK_BLOCKS * BLOCK);
+    return 0.8f * expf(-(float) since / (SAMPLE_RATE * 0.05f)) * sinf(2 * M_PI * since / BLOCK);
+}
+
+static FILE *generate()
+{
+    uint32_t samples = (DDAudioAnalyzer::NUM_BANDS * TONE_BLOCKS + KICKS * KICK_BLOCKS) * BLOCK;
+    FILE *file = tmpfile();
+    if (!file) {
+        return NULL;
+    }
+    fwrite("RIFF", 1, 4, file);
+    writeLE(file, 36 + samples * 4, 4);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2);
+    writeLE(file, 2, 2);
+    writeLE(file, SAMPLE_RATE, 4);
+    writeLE(file, SAMPLE_RATE * 4, 4);
+    writeLE(file, 4, 2);
+    writeLE(file, 16, 2);
+    fwrite("data", 1, 4, file);
+    writeLE(file, samples * 4, 4);
+    for (uint32_t n = 0; n < samples; n++) {
+        int16_t value = signal(n) * 32767;
+        // the same signal on both channels, the mix down keeps it
+        writeLE(file, (uint16_t) value, 2);
+        writeLE(file, (uint16_t) value, 2);
+    }
+    rewind(file);
+    return file;
+}
+
+static bool check(const char *name, bool ok)
+{
+    printf("%s: %s\n", name, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    bool generated = argc < 2;
+    FILE *file = generated ? generate() : fopen(argv[1], "rb");
+    DDWavReader reader;
+    if (!file || !reader.open(file)) {
+        printf("no 16 bit PCM WAV file\n");
+        return 1;
+    }
+    uint32_t period = (uint32_t) BLOCK * 1000000 / reader.getSampleRate();
+
+    DDBooster booster(0, 0, 0, NC);
+    booster.init(64);
+    DDFrameBuffer frame(booster);
+    DDAudioVisualizer visualizer(frame);
+    visualizer.setLatencyBound(period);
+    // sees the same blocks as the visualizer, which keeps its analyzer to itself
+    DDAudioAnalyzer analyzer;
+
+    int16_t block[BLOCK];
+    uint32_t blocks = 0, beats = 0, shown = 0, kickBeats = 0, kicksFound = 0;
+    uint32_t levelSum[DDAudioAnalyzer::NUM_BANDS] = {0};
+    bool bandsOk = true;
+    uint32_t next = us_ticker_read();
+    while (reader.read(block, BLOCK) == BLOCK) {
+        while ((int32_t) (us_ticker_read() - next) < 0) {
+        }
+        next += period;
+
+        visualizer.push(block);
+        shown += visualizer.poll() ? 1 : 0;
+        analyzer.analyze(block);
+        beats += analyzer.isBeat() ? 1 : 0;
+        for (uint8_t b = 0; b < DDAudioAnalyzer::NUM_BANDS; b++) {
+            levelSum[b] += analyzer.getLevel(b);
+        }
+
+        uint8_t band = blocks / TONE_BLOCKS;
+        if (generated && band < DDAudioAnalyzer::NUM_BANDS && blocks % TONE_BLOCKS >= TONE_BLOCKS / 2) {
+            // the second half of each tone, the levels have settled
+            bool ok = analyzer.getLevel(band) >= 192;
+            for (uint8_t b = 0; b < DDAudioAnalyzer::NUM_BANDS; b++) {
+                if (b + 2 <= band || b >= band + 2) {
+                    ok = ok && analyzer.getLevel(b) < 64;
+                }
+            }
+            if (!ok && bandsOk) {
+                printf("band %u, block %lu:", band, (unsigned long) blocks);
+                for (uint8_t b = 0; b < DDAudioAnalyzer::NUM_BANDS; b++) {
+                    printf(" %u", analyzer.getLevel(b));
+                }
+                printf("\n");
+            }
+            bandsOk = bandsOk && ok;
+        }
+        if (generated && band >= DDAudioAnalyzer::NUM_BANDS && analyzer.isBeat()) {
+            // a beat at the start of a kick, no others
+            kickBeats++;
+            if ((blocks - DDAudioAnalyzer::NUM_BANDS * TONE_BLOCKS) % KICK_BLOCKS < 2) {
+                kicksFound++;
+            }
+        }
+        blocks++;
+    }
+
+    printf("%lu blocks of %lu us, %lu shown, %lu beats, latency max %lu us, levels",
+           (unsigned long) blocks, (unsigned long) period, (unsigned long) shown, (unsigned long) beats,
+           (unsigned long) visualizer.getLatencyMax());
+    for (uint8_t b = 0; b < DDAudioAnalyzer::NUM_BANDS; b++) {
+        printf(" %lu", (unsigned long) (blocks ? levelSum[b] / blocks : 0));
+    }
+    printf("\n");
+
+    bool ok = true;
+    ok = check("all blocks shown within the bound", blocks > 0 && shown == blocks
+               && visualizer.getDroppedBlocks() == 0 && visualizer.getLatencyMax() <= period) && ok;
+    if (generated) {
+        ok = check("band levels", bandsOk) && ok;
+        ok = check("beats", kicksFound == KICKS && kickBeats == KICKS) && ok;
+    }
+
+    // replaced and stale blocks
+    DDAudioVisualizer late(frame);
+    late.setLatencyBound(period);
+    uint32_t replaced = 0, stale = 0;
+    shown = 0;
+    bool staleShown = false;
+    memset(block, 0, sizeof (block));
+    for (uint16_t i = 0; i < 100; i++) {
+        late.push(block);
+        if (i % 10 == 3) {
+            late.push(block);
+            replaced++;
+        }
+        if (i % 10 == 7) {
+            host_advance_time(period + 1);
+            stale++;
+            staleShown = late.poll() || staleShown;
+            continue;
+        }
+        shown += late.poll() ? 1 : 0;
+    }
+    ok = check("replaced and stale blocks dropped", !staleShown && shown == 100 - stale
+               && late.getDroppedBlocks() == replaced + stale) && ok;
+
+    fclose(file);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+/*
+ * bus_scaling.cpp - Measures DDBusController with 1 to MAX_BUSES buses on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -O2 -DMBED_CONF_RTOS_PRESENT=1 -Ibench/host -I. -o bus_scaling \
+ *       bench/host/bus_scaling.cpp DDBusController.cpp DDFrameBuffer.cpp DDBooster.cpp -lpthread
+ *   ./bus_scaling [ms]
+ *
+ * Each bus drives one strip of 60 LEDs with a moving dot. The bus time is modeled in the
+ * transmit thread: every transaction sleeps for the command delay plus its bytes at 12MHz,
+ * SHOW additionally for the LED update. All strips are submitted as fast as the controller
+ * accepts them for the given time (500 ms) per bus count. Prints one JSON line per bus count
+ * and exits with 1 if the slowest bus of any run reaches less than 80% of the frame rate of
+ * a single bus, i.e. if the buses do not run in parallel.
+ */
+
+#include "DDBusController.h"
+#include "DDBoosterProtocol.h"
+#include <thread>
+
+static const uint16_t LEDS = 60;
+
+static void onTransaction(const uint8_t *data, uint8_t length)
+{
+    uint32_t time = BOOSTER_CMD_DELAY + length * 8 / 12;
+    if (DDBooster::containsShow(data, length)) {
+        time += BOOSTER_LED_DELAY * LEDS;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(time));
+}
+
+static void render(DDFrameBuffer &frame)
+{
+    // one dot moving by one LED per frame, three LEDs change
+    uint8_t *data = frame.getData();
+    uint16_t dot = 0;
+    while (dot < LEDS && data[dot * 3] == 0) {
+        dot++;
+    }
+    memset(data, 0, LEDS * 3);
+    frame.setPixel((dot + 1) % LEDS, 255, 64, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t duration = argc > 1 ? atoi(argv[1]) : 500;
+
+    bool ok = true;
+    uint32_t single = 0;
+    for (uint8_t buses = 1; buses <= DDBusController::MAX_BUSES; buses++) {
+        // the threads of a controller never end, it lives until the end of the program
+        DDBusController *controller = new DDBusController();
+        for (uint8_t i = 0; i < buses; i++) {
+            DDBooster *booster = new DDBooster(0, 0, 0, NC);
+            booster->init(LEDS);
+            booster->attachMonitor(onTransaction);
+            DDFrameBuffer *frame = new DDFrameBuffer(*booster);
+            controller->addBus();
+            controller->addStrip(i, *frame, render);
+        }
+        controller->start();
+        controller->resetStatistics();
+
+        uint32_t start = us_ticker_read();
+        while (us_ticker_read() - start < duration * 1000) {
+            controller->submitAll();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        uint32_t total = 0, slowest = 0xFFFFFFFF, utilization = 0;
+        for (uint8_t i = 0; i < buses; i++) {
+            uint32_t frames = controller->getFrameCount(i);
+            total += frames;
+            slowest = frames < slowest ? frames : slowest;
+            utilization += controller->getUtilization(i);
+        }
+        uint32_t fps = slowest * 1000 / duration;
+        if (buses == 1) {
+            single = fps;
+        }
+        bool parallel = fps * 10 >= single * 8;
+        ok = ok && parallel;
+        printf("{\"buses\":%u,\"fps_total\":%lu,\"fps_min\":%lu,\"utilization_avg\":%lu,\"parallel\":%s}\n",
+               buses, (unsigned long) (total * 1000 / duration), (unsigned long) fps,
+               (unsigned long) (utilization / buses), parallel ? "true" : "false");
+    }
+    fflush(stdout);
+    return ok ? 0 : 1;
+}
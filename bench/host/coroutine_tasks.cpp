@@ -0,0 +1,120 @@
+/*
+ * coroutine_tasks.cpp - Drives many DD-Boosters with coroutine tasks from one thread on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder, needs a C++20 compiler:
+ *
+ *   g++ -std=c++20 -O2 -Ibench/host -I. -o coroutine_tasks bench/host/coroutine_tasks.cpp \
+ *       DDTask.cpp DDBooster.cpp
+ *   ./coroutine_tasks [boosters] [ms]
+ *
+ * Each booster (31 by default) runs a chase effect written as a coroutine, one more booster
+ * a chase written with the DD_TASK_* macros, all in one DDTaskScheduler for the given time
+ * (1000 ms). The commands use deferred delays, a task awaiting DDReady must never find the
+ * DD-Booster busy, so the wait time of every booster must not grow. Prints the frames per
+ * booster and exits with 1 if any booster had to wait.
+ */
+
+#include "DDTask.h"
+
+static const uint8_t MAX_BOOSTERS = DDTaskScheduler::MAX_TASKS - 1;
+static const uint8_t LEDS = 60;
+
+static DDCoroutineTask chase(DDBooster &booster)
+{
+    for (uint32_t frame = 0; ; frame++) {
+        uint8_t led = frame % LEDS;
+        co_await DDReady(booster);
+        booster.clearAll();
+        co_await DDReady(booster);
+        booster.setLED(led, 255, 0, 0);
+        co_await DDReady(booster);
+        booster.show();
+        co_yield frame;
+        co_await DDSleep(1);
+    }
+}
+
+class MacroChase : public DDTask {
+public:
+    MacroChase(DDBooster &booster)
+        : _booster(booster)
+        , _frame(0)
+    {
+    }
+
+    virtual bool run()
+    {
+        DD_TASK_BEGIN();
+        for (;;) {
+            DD_TASK_AWAIT_READY(_booster); _booster.clearAll();
+            DD_TASK_AWAIT_READY(_booster); _booster.setLED(_frame % LEDS, 0, 0, 255);
+            DD_TASK_AWAIT_READY(_booster); _booster.show();
+            _frame++;
+            DD_TASK_SLEEP(1);
+        }
+        DD_TASK_END();
+    }
+
+    uint32_t getFrame() const
+    {
+        return _frame;
+    }
+
+private:
+    DDBooster &_booster;
+    uint32_t _frame;
+};
+
+int main(int argc, char *argv[])
+{
+    uint8_t count = argc > 1 ? atoi(argv[1]) : MAX_BOOSTERS;
+    uint32_t duration = argc > 2 ? atoi(argv[2]) : 1000;
+    if (count > MAX_BOOSTERS) {
+        count = MAX_BOOSTERS;
+    }
+
+    // boosters and tasks live until the end of the program
+    DDBooster *boosters[MAX_BOOSTERS + 1];
+    uint32_t waited[MAX_BOOSTERS + 1];
+    DDCoroutineTask *tasks[MAX_BOOSTERS];
+    DDTaskScheduler scheduler;
+    for (uint8_t i = 0; i <= count; i++) {
+        boosters[i] = new DDBooster(0, 0, 0, NC);
+        boosters[i]->init(LEDS);
+        boosters[i]->setDeferredDelays(true);
+        // init() waited with blocking delays
+        waited[i] = boosters[i]->getWaitTime();
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        tasks[i] = new DDCoroutineTask(chase(*boosters[i]));
+        scheduler.add(*tasks[i]);
+    }
+    MacroChase macro(*boosters[count]);
+    scheduler.add(macro);
+
+    uint32_t start = us_ticker_read();
+    uint32_t polls = 0;
+    while (us_ticker_read() - start < duration * 1000) {
+        scheduler.poll();
+        polls++;
+    }
+
+    bool ok = true;
+    uint32_t minFrames = 0xFFFFFFFF, maxFrames = 0;
+    for (uint8_t i = 0; i <= count; i++) {
+        uint32_t frames = i < count ? tasks[i]->getFrame() + 1 : macro.getFrame();
+        minFrames = frames < minFrames ? frames : minFrames;
+        maxFrames = frames > maxFrames ? frames : maxFrames;
+        ok = ok && boosters[i]->getWaitTime() == waited[i];
+    }
+
+    printf("{\"boosters\":%u,\"ms\":%lu,\"polls\":%lu,\"frames_min\":%lu,\"frames_max\":%lu,\"blocked\":%s}\n",
+           count + 1, (unsigned long) duration, (unsigned long) polls, (unsigned long) minFrames,
+           (unsigned long) maxFrames, ok ? "false" : "true");
+    return ok ? 0 : 1;
+}
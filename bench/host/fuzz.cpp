@@ -0,0 +1,42 @@
+/*
+ * fuzz.cpp - Runs DDFuzzer on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -Ibench/host -I. -Ibench -o fuzz bench/host/fuzz.cpp bench/DDFuzzer.cpp \
+ *       DDBooster.cpp DDFrameBuffer.cpp DDBoosterEmulator.cpp DDScene.cpp
+ *   ./fuzz [cases] [seed]
+ *
+ * Runs the given number of frame and scene cases (default 1000 each) starting with the seed
+ * (default 1) and prints the results as one JSON line. A failure prints the seed and the
+ * number of the first failed case and exits with 1, the same seed reproduces it.
+ */
+
+#include "DDFuzzer.h"
+
+int main(int argc, char *argv[])
+{
+    uint16_t cases = argc > 1 ? atoi(argv[1]) : 1000;
+    uint32_t seed = argc > 2 ? strtoul(argv[2], NULL, 0) : 1;
+
+    DDBooster optimized(0, 0, 0, NC);
+    DDBooster naive(0, 0, 0, NC);
+    DDFuzzer fuzzer(optimized, naive, seed);
+
+    bool ok = fuzzer.runFrames(cases);
+    ok = fuzzer.runScenes(cases) && ok;
+
+    const DDFuzzer::Stats &stats = fuzzer.getStats();
+    printf("{\"seed\":%lu,\"cases\":%lu,\"failures\":%lu,\"first_failure\":%lu,"
+           "\"optimized_bytes\":%lu,\"naive_bytes\":%lu,\"optimized_us\":%lu,\"naive_us\":%lu}\n",
+           (unsigned long) seed, (unsigned long) stats.cases, (unsigned long) stats.failures,
+           (unsigned long) fuzzer.getFirstFailure(), (unsigned long) stats.optimizedBytes,
+           (unsigned long) stats.naiveBytes, (unsigned long) stats.optimizedTime,
+           (unsigned long) stats.naiveTime);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+/*
+ * mbed.h - Minimal stand-in for the mbed API to run the benchmarks and checks on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_HOST_MBED_H
+#define DD_BOOSTER_HOST_MBED_H
+
+/*
+ * Only the parts used by the DD-Booster core (DDBooster, DDFrameBuffer, DDBoosterEmulator,
+ * DDScene, DDSerialReceiver) are provided. Nothing is sent, SPI transfers are dropped and
+ * the delays return immediately, the traffic is observed with DDBooster::attachMonitor().
+ * The time comes from the steady clock of the host, host programs simulating long runs can
+ * move it forward with host_advance_time(). Critical sections lock a mutex, so they also
+ * hold against the threads of the rtos.h stand-in.
+ *
+ * This folder is picked up with -Ibench/host before the library folder, see the host
+ * programs in this folder for the compiler command lines.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+typedef int PinName;
+
+#define NC (-1)
+
+inline uint32_t &host_time_offset()
+{
+    static uint32_t offset = 0;
+    return offset;
+}
+
+inline void host_advance_time(uint32_t us)
+{
+    host_time_offset() += us;
+}
+
+inline uint32_t us_ticker_read()
+{
+    return (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count() + host_time_offset();
+}
+
+inline void wait_us(int us)
+{
+}
+
+inline void wait_ms(int ms)
+{
+}
+
+// a critical section shuts out the threads of the host RTOS stand-in
+inline std::recursive_mutex &host_critical_section()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+inline void core_util_critical_section_enter()
+{
+    host_critical_section().lock();
+}
+
+inline void core_util_critical_section_exit()
+{
+    host_critical_section().unlock();
+}
+
+template <typename F>
+class Callback;
+
+template <typename R, typename... A>
+class Callback<R(A...)> {
+public:
+    Callback()
+    {
+    }
+
+    Callback(R (*function)(A...))
+        : _function(function)
+    {
+    }
+
+    template <typename T>
+    Callback(T *object, R (T::*method)(A...))
+        : _function([object, method](A... args) { return (object->*method)(args...); })
+    {
+    }
+
+    R call(A... args) const
+    {
+        return _function(args...);
+    }
+
+    R operator()(A... args) const
+    {
+        return call(args...);
+    }
+
+    operator bool() const
+    {
+        return (bool) _function;
+    }
+
+private:
+    std::function<R(A...)> _function;
+};
+
+template <typename T, typename R, typename... A>
+Callback<R(A...)> callback(T *object, R (T::*method)(A...))
+{
+    return Callback<R(A...)>(object, method);
+}
+
+class SPI {
+public:
+    SPI(PinName mosi, PinName miso, PinName sclk)
+    {
+    }
+
+    void format(int bits, int mode = 0)
+    {
+    }
+
+    void frequency(int hz)
+    {
+    }
+
+    int write(int value)
+    {
+        return 0;
+    }
+
+    int write(const char *tx, int txLength, char *rx, int rxLength)
+    {
+        return txLength;
+    }
+};
+
+class DigitalOut {
+public:
+    DigitalOut(PinName pin, int value = 0)
+        : _pin(pin)
+        , _value(value)
+    {
+    }
+
+    DigitalOut &operator=(int value)
+    {
+        _value = value;
+        return *this;
+    }
+
+    operator int()
+    {
+        return _value;
+    }
+
+    int is_connected()
+    {
+        return _pin != NC;
+    }
+
+private:
+    PinName _pin;
+    int _value;
+};
+
+class Timer {
+public:
+    Timer()
+        : _running(false)
+        , _start(0)
+        , _elapsed(0)
+    {
+    }
+
+    void start()
+    {
+        if (!_running) {
+            _start = us_ticker_read();
+            _running = true;
+        }
+    }
+
+    void stop()
+    {
+        _elapsed = read_us();
+        _running = false;
+    }
+
+    void reset()
+    {
+        _start = us_ticker_read();
+        _elapsed = 0;
+    }
+
+    int read_us()
+    {
+        return _running ? _elapsed + (us_ticker_read() - _start) : _elapsed;
+    }
+
+    int read_ms()
+    {
+        return read_us() / 1000;
+    }
+
+private:
+    bool _running;
+    uint32_t _start;
+    uint32_t _elapsed;
+};
+
+class RawSerial {
+public:
+    enum IrqType {
+        RxIrq,
+        TxIrq
+    };
+
+    RawSerial(PinName tx, PinName rx, int baud = 9600)
+    {
+    }
+
+    bool readable()
+    {
+        return false;
+    }
+
+    int getc()
+    {
+        return -1;
+    }
+
+    void attach(Callback<void()> function, IrqType type = RxIrq)
+    {
+    }
+};
+
+#endif //DD_BOOSTER_HOST_MBED_H
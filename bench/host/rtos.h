@@ -0,0 +1,127 @@
+/*
+ * rtos.h - Minimal stand-in for the mbed RTOS on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+#ifndef DD_BOOSTER_HOST_RTOS_H
+#define DD_BOOSTER_HOST_RTOS_H
+
+/*
+ * Threads are host threads without priorities, queues block on a condition variable. Only
+ * the parts used by DDBusController are provided. A thread which never returns is detached
+ * when its object is destroyed, so keep such objects until the end of the program.
+ */
+
+#include "mbed.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+typedef enum {
+    osPriorityIdle,
+    osPriorityLow,
+    osPriorityBelowNormal,
+    osPriorityNormal,
+    osPriorityAboveNormal,
+    osPriorityHigh,
+    osPriorityRealtime
+} osPriority;
+
+typedef int osStatus;
+
+enum {
+    osOK = 0,
+    osEventMessage = 0x10,
+    osErrorResource = 0x81
+};
+
+#define osWaitForever 0xFFFFFFFFu
+
+struct osEvent {
+    osStatus status;
+    union {
+        void *p;
+        uint32_t v;
+    } value;
+};
+
+class Thread {
+public:
+    ~Thread()
+    {
+        if (_thread.joinable()) {
+            _thread.detach();
+        }
+    }
+
+    osStatus start(Callback<void()> task)
+    {
+        _thread = std::thread([task]() {
+            task();
+        });
+        return osOK;
+    }
+
+    osStatus set_priority(osPriority priority)
+    {
+        return osOK;
+    }
+
+    osStatus join()
+    {
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+        return osOK;
+    }
+
+private:
+    std::thread _thread;
+};
+
+template <typename T, uint32_t N>
+class Queue {
+public:
+    Queue()
+        : _first(0)
+        , _count(0)
+    {
+    }
+
+    osStatus put(T *data, uint32_t millisec = 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_count == N) {
+                return osErrorResource;
+            }
+            _items[(_first + _count++) % N] = data;
+        }
+        _changed.notify_one();
+        return osOK;
+    }
+
+    osEvent get(uint32_t millisec = osWaitForever)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [this]() {
+            return _count > 0;
+        });
+        osEvent event;
+        event.status = osEventMessage;
+        event.value.p = _items[_first];
+        _first = (_first + 1) % N;
+        _count--;
+        return event;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    T *_items[N];
+    uint32_t _first;
+    uint32_t _count;
+};
+
+#endif //DD_BOOSTER_HOST_RTOS_H
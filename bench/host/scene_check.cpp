@@ -0,0 +1,110 @@
+/*
+ * scene_check.cpp - Checks the scene compiler output and the looping player on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -Ibench/host -I. -o scene_check bench/host/scene_check.cpp \
+ *       DDScene.cpp DDBooster.cpp
+ *   ./scene_check
+ *
+ * Compiles scripts and checks that a wait at the end of the script is kept in the stream,
+ * that a looping player keeps the last frame for that time before it starts again and that
+ * byte arguments above 255 are rejected. Exits with 0 if all checks passed.
+ */
+
+#include "DDScene.h"
+#include "DDBoosterProtocol.h"
+
+static uint8_t stream[256];
+static uint32_t showTimes[8];
+static uint8_t shows;
+
+static void onTransaction(const uint8_t *data, uint8_t length)
+{
+    if (shows < 8 && data[length - 1] == BOOSTER_SHOW) {
+        showTimes[shows++] = us_ticker_read();
+    }
+}
+
+// sums up the delays of all records and returns the delay and length of the last one
+static bool decode(uint32_t length, uint32_t *total, uint32_t *lastDelay, uint8_t *lastLength)
+{
+    uint32_t p = 0;
+    *total = 0;
+    while (p < length) {
+        uint32_t delay = 0;
+        for (uint8_t shift = 0; ; shift += 7) {
+            delay |= (uint32_t) (stream[p] & 0x7F) << shift;
+            if (!(stream[p++] & 0x80)) {
+                break;
+            }
+        }
+        *total += delay;
+        *lastDelay = delay;
+        *lastLength = stream[p++];
+        p += *lastLength;
+    }
+    return p == length;
+}
+
+static bool check(const char *name, bool ok)
+{
+    printf("%s: %s\n", name, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static bool rejects(const char *script, const char *error)
+{
+    DDSceneCompiler compiler(stream, sizeof (stream));
+    return !compiler.compile(script) && compiler.getError() && strcmp(compiler.getError(), error) == 0;
+}
+
+int main()
+{
+    bool ok = true;
+    DDSceneCompiler compiler(stream, sizeof (stream));
+
+    const char *script =
+        "leds 10\n"
+        "rgb 255 0 0\n"
+        "all\n"
+        "show\n"
+        "wait 500\n"
+        "rgb 0 0 255\n"
+        "all\n"
+        "show\n"
+        "wait 500\n";
+    uint32_t total = 0, lastDelay = 0;
+    uint8_t lastLength = 0xFF;
+    ok = check("compile", compiler.compile(script)) && ok;
+    ok = check("trailing wait kept", decode(compiler.getLength(), &total, &lastDelay, &lastLength)
+               && total == 1000 && lastDelay == 500 && lastLength == 0) && ok;
+
+    ok = check("rgb 300 rejected", rejects("rgb 300 0 0\n", "value out of range")) && ok;
+    ok = check("shift count 400 rejected", rejects("leds 10\nshift up 0 9 400\n", "value out of range")) && ok;
+    ok = check("gradient 256 rejected", rejects("gradient 0 9 0 0 0 0 256 0\n", "value out of range")) && ok;
+    ok = check("hsv saturation 256 rejected", rejects("hsv 400 256 0\n", "value out of range")) && ok;
+    ok = check("hsv hue 400 accepted", compiler.compile("hsv 400 255 255\nall\n")) && ok;
+
+    // the player keeps the second frame for the trailing wait before the first one again
+    compiler.compile("rgb 255 0 0\nall\nshow\nwait 50\nrgb 0 0 255\nall\nshow\nwait 50\n");
+    DDBooster booster(0, 0, 0, NC);
+    booster.init(10);
+    booster.attachMonitor(onTransaction);
+    DDScenePlayer player(booster, stream, compiler.getLength(), true);
+    player.start();
+    uint32_t start = us_ticker_read();
+    while (shows < 3 && us_ticker_read() - start < 1000000) {
+        player.update();
+    }
+    uint32_t gap = shows == 3 ? (showTimes[2] - showTimes[1]) / 1000 : 0;
+    printf("loop gap %lu ms\n", (unsigned long) gap);
+    ok = check("loop keeps the last frame", gap >= 50 && gap < 60) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/*
+ * serial_check.cpp - Feeds TPM2 and Adalight streams through DDSerialReceiver on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -Ibench/host -I. -o serial_check bench/host/serial_check.cpp \
+ *       DDBooster.cpp DDFrameBuffer.cpp DDBoosterEmulator.cpp DDSerialReceiver.cpp
+ *   ./serial_check
+ *
+ * Random frames are encoded in both protocols and fed byte by byte with feed(). After each
+ * frame the LEDs shown by an emulator attached to the booster must equal the frame, exactly
+ * one SHOW must have been sent and the bytes of the first frame must stay below twice the
+ * bytes of a single complete transmission. Corrupted frames must be counted as errors
+ * without a SHOW. Exits with 0 if all checks passed.
+ */
+
+#include "DDSerialReceiver.h"
+#include "DDBoosterEmulator.h"
+
+static const uint16_t LED_COUNT = 100;
+static const uint16_t FRAMES = 200;
+
+static DDBoosterEmulator emulator;
+static uint32_t shows;
+static uint32_t random32 = 1;
+static uint8_t pixels[LED_COUNT * 3];
+
+static void onTransaction(const uint8_t *data, uint8_t length)
+{
+    emulator.process(data, length);
+    if (DDBooster::containsShow(data, length)) {
+        shows++;
+    }
+}
+
+static uint32_t nextRandom(uint32_t range)
+{
+    // xorshift32
+    random32 ^= random32 << 13;
+    random32 ^= random32 >> 17;
+    random32 ^= random32 << 5;
+    return random32 % range;
+}
+
+static void randomPixels()
+{
+    // mostly small changes of the previous frame, sometimes a new frame
+    if (nextRandom(8) == 0) {
+        for (uint16_t i = 0; i < sizeof (pixels); i++) {
+            pixels[i] = nextRandom(4) * 64;
+        }
+    } else {
+        for (uint8_t n = nextRandom(10); n > 0; n--) {
+            memset(pixels + nextRandom(LED_COUNT) * 3, nextRandom(256), 3);
+        }
+    }
+}
+
+static void feedFrame(DDSerialReceiver &receiver, DDSerialReceiver::Protocol protocol, bool corrupt)
+{
+    if (protocol == DDSerialReceiver::PROTOCOL_TPM2) {
+        uint16_t size = sizeof (pixels);
+        receiver.feed(0xC9);
+        receiver.feed(0xDA);
+        receiver.feed(size >> 8);
+        receiver.feed(size & 0xFF);
+        for (uint16_t i = 0; i < size; i++) {
+            receiver.feed(pixels[i]);
+        }
+        receiver.feed(corrupt ? 0x00 : 0x36);
+    } else {
+        uint16_t count = LED_COUNT - 1;
+        receiver.feed('A');
+        receiver.feed('d');
+        receiver.feed('a');
+        receiver.feed(count >> 8);
+        receiver.feed(count & 0xFF);
+        receiver.feed(((count >> 8) ^ (count & 0xFF) ^ 0x55) ^ (corrupt ? 1 : 0));
+        if (!corrupt) {
+            for (uint16_t i = 0; i < sizeof (pixels); i++) {
+                receiver.feed(pixels[i]);
+            }
+        }
+    }
+}
+
+static bool shown(const uint8_t *expected)
+{
+    for (uint16_t i = 0; i < LED_COUNT; i++) {
+        if (memcmp(emulator.getShown(i), expected + i * 3, 3) != 0) {
+            return false;
+        }
+    }
+    return emulator.getErrors() == 0;
+}
+
+static bool run(DDBooster &booster, DDSerialReceiver::Protocol protocol, uint16_t chunk)
+{
+    const char *name = protocol == DDSerialReceiver::PROTOCOL_TPM2 ? "tpm2" : "adalight";
+
+    // bytes of the first frame sent at once, as reference
+    memset(pixels, 0, sizeof (pixels));
+    randomPixels();
+    booster.init(LED_COUNT);
+    emulator.reset(LED_COUNT);
+    {
+        DDFrameBuffer frame(booster);
+        memcpy(frame.getData(), pixels, sizeof (pixels));
+        frame.flush();
+    }
+    uint32_t single = emulator.getBytes();
+
+    booster.init(LED_COUNT);
+    emulator.reset(LED_COUNT);
+    DDFrameBuffer frame(booster);
+    DDSerialReceiver receiver(frame, protocol, chunk);
+
+    shows = 0;
+    feedFrame(receiver, protocol, false);
+    uint32_t first = emulator.getBytes();
+    // the black buffer sent before the first chunk is not shown
+    bool ok = shown(pixels) && shows == 1 && first < single * 2;
+    printf("%s chunk %u: first frame %lu bytes, sent at once %lu bytes\n", name, chunk,
+           (unsigned long) first, (unsigned long) single);
+
+    uint32_t errors = 0;
+    uint8_t last[sizeof (pixels)];
+    memcpy(last, pixels, sizeof (pixels));
+    for (uint16_t f = 1; f < FRAMES && ok; f++) {
+        bool corrupt = nextRandom(10) == 0;
+        randomPixels();
+
+        shows = 0;
+        feedFrame(receiver, protocol, corrupt);
+        if (corrupt) {
+            // the LEDs keep showing the last complete frame
+            errors++;
+            ok = shown(last) && shows == 0;
+            if (protocol == DDSerialReceiver::PROTOCOL_ADALIGHT) {
+                // the data of a frame with a wrong header is never written
+                memcpy(pixels, frame.getData(), sizeof (pixels));
+            }
+        } else {
+            ok = shown(pixels) && shows == 1;
+            memcpy(last, pixels, sizeof (pixels));
+        }
+        if (!ok) {
+            printf("%s chunk %u: frame %u failed\n", name, chunk, f);
+        }
+    }
+
+    ok = ok && receiver.getErrorCount() == errors && receiver.getFrameCount() == FRAMES - errors;
+    printf("%s chunk %u: %lu frames, %lu errors, %s\n", name, chunk, (unsigned long) receiver.getFrameCount(),
+           (unsigned long) receiver.getErrorCount(), ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main()
+{
+    DDBooster booster(0, 0, 0, NC);
+    booster.attachMonitor(onTransaction);
+
+    bool ok = true;
+    const uint16_t chunks[] = {1, 16, 1000};
+    for (uint8_t c = 0; c < 3; c++) {
+        ok = run(booster, DDSerialReceiver::PROTOCOL_TPM2, chunks[c]) && ok;
+        ok = run(booster, DDSerialReceiver::PROTOCOL_ADALIGHT, chunks[c]) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/*
+ * timecode_check.cpp - Feeds skewed timecode into DDTimecodePlayer on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -Ibench/host -I. -o timecode_check bench/host/timecode_check.cpp \
+ *       DDTimecodePlayer.cpp
+ *   ./timecode_check
+ *
+ * Simulates a timecode source sending 30 timecodes per second which is offset from the
+ * local clock and runs faster or slower than it. The time is moved forward in steps of one
+ * millisecond, no real time passes. The difference to the timecode must stay below one frame
+ * period of the 25 fps show after the time the slew limit allows, offset divided by
+ * MAX_SLEW_PERMILLE less the drift, plus two seconds. The frames must never run backwards.
+ * Prints the convergence time of each case and exits with 0 if all checks passed.
+ */
+
+#include "DDTimecodePlayer.h"
+
+static const uint16_t FRAME_RATE = 25;
+static const uint32_t FRAME_PERIOD = 1000000 / FRAME_RATE;
+static const uint32_t TIMECODE_PERIOD = 33;
+
+static uint32_t lastFrame;
+static bool backwards;
+
+static void onRender(uint32_t frame)
+{
+    if (frame < lastFrame) {
+        backwards = true;
+    }
+    lastFrame = frame;
+}
+
+// offset in milliseconds, drift of the source in 1/1000
+static bool run(int32_t offset, int32_t drift)
+{
+    DDTimecodePlayer player(onRender, FRAME_RATE);
+    lastFrame = 0;
+    backwards = false;
+
+    const uint32_t start = 60000;
+    uint32_t bound = (offset < 0 ? -offset : offset) * 1000 / (DDTimecodePlayer::MAX_SLEW_PERMILLE - abs(drift))
+                     + 2000;
+    uint32_t duration = bound + 5000;
+    uint32_t converged = 0;
+    bool inside = false;
+
+    player.receiveTimecode(start);
+    for (uint32_t t = 1; t <= duration; t++) {
+        host_advance_time(1000);
+        if (t % TIMECODE_PERIOD == 0) {
+            int64_t remote = start + offset + (int64_t) t * (1000 + drift) / 1000;
+            player.receiveTimecode(remote);
+            bool close = player.getLastError() < FRAME_PERIOD && player.getLastError() > -(int64_t) FRAME_PERIOD;
+            if (close && !inside) {
+                converged = t;
+            }
+            inside = close;
+        }
+        player.update();
+    }
+
+    bool ok = inside && converged <= bound && !backwards;
+    printf("offset %ld ms, drift %ld/1000: converged after %lu ms (bound %lu ms), last error %ld us, %s\n",
+           (long) offset, (long) drift, (unsigned long) converged, (unsigned long) bound,
+           (long) player.getLastError(), ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main()
+{
+    bool ok = true;
+    ok = run(450, 0) && ok;
+    ok = run(-450, 0) && ok;
+    ok = run(200, 10) && ok;
+    ok = run(-200, -10) && ok;
+    ok = run(30, 20) && ok;
+    ok = run(-300, 30) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/*
+ * video_bench.cpp - Measures DDVideoMapper with 1080p input on 2048 LEDs on a PC
+ *
+ * https://github.com/Gamadril/DD-Booster-mbed
+ * MIT License
+ */
+
+/*
+ * Build and run from the library folder:
+ *
+ *   g++ -std=c++11 -O2 -Ibench/host -I. -o video_bench bench/host/video_bench.cpp \
+ *       DDVideoMapper.cpp DDBooster.cpp DDFrameBuffer.cpp
+ *   ./video_bench [width height [frames]]
+ *
+ * A 64 x 32 LED matrix split over 8 frame buffers covers the image, 1920 x 1080 by default,
+ * each LED samples the area of its cell (30 x 33.75 pixels at 1080p). The image moves by one
+ * pixel per frame.
+ * Prints the average and maximal map() time and the largest difference of a LED to the
+ * exact average of its area as one JSON line.
+ */
+
+#include "DDVideoMapper.h"
+
+static const uint16_t MAX_WIDTH = 1920;
+static const uint16_t MAX_HEIGHT = 1080;
+static const uint16_t COLUMNS = 64;
+static const uint16_t ROWS = 32;
+static const uint16_t LEDS = COLUMNS * ROWS;
+static const uint8_t BUFFERS = LEDS / DDFrameBuffer::MAX_LEDS;
+
+static uint8_t image[MAX_WIDTH * MAX_HEIGHT * 3];
+static uint16_t width = MAX_WIDTH;
+static uint16_t height = MAX_HEIGHT;
+static DDSampleWindow table[LEDS];
+
+static void render(uint16_t frame)
+{
+    // smooth gradients with a hard edge, the worst case for point sampling
+    for (uint16_t y = 0; y < height; y++) {
+        uint8_t *px = image + y * width * 3;
+        for (uint16_t x = 0; x < width; x++) {
+            uint16_t sx = x + frame;
+            px[0] = sx * 255 / (width + 1000);
+            px[1] = y * 255 / height;
+            px[2] = (sx / 7 + y / 5) & 1 ? 255 : 0;
+            px += 3;
+        }
+    }
+}
+
+static uint8_t exact(uint16_t led, uint8_t c)
+{
+    // area of the LED cell, edge pixels weighted by their coverage, in 1/256 pixels
+    uint32_t x0 = (uint32_t) (led % COLUMNS) * width * 256 / COLUMNS;
+    uint32_t x1 = (uint32_t) (led % COLUMNS + 1) * width * 256 / COLUMNS;
+    uint32_t y0 = (uint32_t) (led / COLUMNS) * height * 256 / ROWS;
+    uint32_t y1 = (uint32_t) (led / COLUMNS + 1) * height * 256 / ROWS;
+    uint64_t sum = 0, area = 0;
+    for (uint32_t y = y0 >> 8; y <= (y1 - 1) >> 8; y++) {
+        uint32_t wy = ((y + 1) << 8 < y1 ? (y + 1) << 8 : y1) - (y << 8 > y0 ? y << 8 : y0);
+        for (uint32_t x = x0 >> 8; x <= (x1 - 1) >> 8; x++) {
+            uint32_t wx = ((x + 1) << 8 < x1 ? (x + 1) << 8 : x1) - (x << 8 > x0 ? x << 8 : x0);
+            sum += (uint64_t) image[(y * width + x) * 3 + c] * wx * wy;
+            area += wx * wy;
+        }
+    }
+    return (sum + area / 2) / area;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        width = atoi(argv[1]) > MAX_WIDTH ? MAX_WIDTH : atoi(argv[1]);
+        height = atoi(argv[2]) > MAX_HEIGHT ? MAX_HEIGHT : atoi(argv[2]);
+    }
+    uint16_t frames = argc > 3 ? atoi(argv[3]) : 100;
+
+    DDBooster *boosters[BUFFERS];
+    DDFrameBuffer *buffers[BUFFERS];
+    for (uint8_t i = 0; i < BUFFERS; i++) {
+        boosters[i] = new DDBooster(0, 0, 0, NC);
+        boosters[i]->init(DDFrameBuffer::MAX_LEDS);
+        buffers[i] = new DDFrameBuffer(*boosters[i]);
+    }
+
+    DDVideoMapper mapper(table, LEDS);
+    mapper.setSampleSize(65536 / COLUMNS, 65536 / ROWS);
+    for (uint16_t i = 0; i < LEDS; i++) {
+        // LED centers on the cell centers
+        uint16_t u = (2 * (i % COLUMNS) + 1) * 32768 / COLUMNS;
+        uint16_t v = (2 * (i / COLUMNS) + 1) * 32768 / ROWS;
+        mapper.addLed(*buffers[i / DDFrameBuffer::MAX_LEDS], i % DDFrameBuffer::MAX_LEDS, u, v);
+    }
+    mapper.build(width, height);
+
+    uint64_t total = 0;
+    uint32_t longest = 0;
+    int maxError = 0;
+    for (uint16_t f = 0; f < frames; f++) {
+        render(f);
+        mapper.map(image);
+        total += mapper.getMapTime();
+        if (mapper.getMapTime() > longest) {
+            longest = mapper.getMapTime();
+        }
+
+        if (f == 0 || f == frames - 1) {
+            for (uint16_t i = 0; i < LEDS; i++) {
+                const uint8_t *px = buffers[i / DDFrameBuffer::MAX_LEDS]->getData() + (i % DDFrameBuffer::MAX_LEDS) * 3;
+                for (uint8_t c = 0; c < 3; c++) {
+                    int error = abs(px[c] - exact(i, c));
+                    if (error > maxError) {
+                        maxError = error;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("{\"width\":%u,\"height\":%u,\"leds\":%u,\"frames\":%u,\"map_avg_us\":%lu,\"map_max_us\":%lu,\"max_error\":%d}\n",
+           width, height, LEDS, frames, (unsigned long) (total / frames), (unsigned long) longest, maxError);
+    return 0;
+}